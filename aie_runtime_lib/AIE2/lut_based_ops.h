@@ -106,5 +106,57 @@ __attribute__((always_inline)) v16bfloat16 getTanhBf16(v16bfloat16 vInput) {
 
   return (v16bfloat16)output;
 }
+
+// Compute gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+__attribute__((always_inline)) v16bfloat16 getGeluTanhBf16(v16bfloat16 vInput) {
+  constexpr bfloat16 sqrt2OverPi = 0.7978845608028654;
+  constexpr bfloat16 c = 0.044715;
+  constexpr bfloat16 half = 0.5;
+  constexpr bfloat16 one = 1.0;
+  aie::vector<bfloat16, 16> x = vInput;
+
+  // sqrt(2 / pi) * x * (1 + c * x^2)
+  aie::accum<accfloat, 16> acc = aie::mul_square(x);
+  acc = aie::mul(acc.to_vector<bfloat16>(), c);
+  aie::vector<bfloat16, 16> inner = aie::add(acc.to_vector<bfloat16>(), one);
+  acc = aie::mul(inner, x);
+  acc = aie::mul(acc.to_vector<bfloat16>(), sqrt2OverPi);
+
+  aie::vector<bfloat16, 16> tanhX =
+      getTanhBf16((v16bfloat16)acc.to_vector<bfloat16>());
+  aie::vector<bfloat16, 16> s = aie::add(tanhX, one);
+  acc = aie::mul(x, half);
+  acc = aie::mul(acc.to_vector<bfloat16>(), s);
+  aie::vector<bfloat16, 16> output = acc.to_vector<bfloat16>();
+  return (v16bfloat16)output;
+}
+
+// Numerically stable softmax over 'size' bfloat16 elements, 'size' being a
+// multiple of 16: out = exp(in - max(in)) / sum(exp(in - max(in))). The
+// exponentials are written to 'out' and summed in fp32, then scaled in place
+// by the LUT-based reciprocal of the sum.
+__attribute__((always_inline)) void softmaxBf16(bfloat16 *in, bfloat16 *out,
+                                                int size) {
+  constexpr int N = 16;
+
+  aie::vector<bfloat16, N> maxVec = aie::load_v<N>(in);
+  for (int i = N; i < size; i += N)
+    maxVec = aie::max(maxVec, aie::load_v<N>(in + i));
+  bfloat16 maxVal = aie::reduce_max(maxVec);
+
+  aie::accum<accfloat, N> sumAcc = aie::zeros<accfloat, N>();
+  for (int i = 0; i < size; i += N) {
+    aie::vector<bfloat16, N> x = aie::sub(aie::load_v<N>(in + i), maxVal);
+    aie::accum<accfloat, N> expX = getExpBf16((v16bfloat16)x);
+    aie::store_v(out + i, expX.to_vector<bfloat16>());
+    sumAcc = aie::add(sumAcc, expX.to_vector<float>());
+  }
+  bfloat16 invSum = getInvBf16(aie::reduce_add(sumAcc.to_vector<float>()));
+
+  for (int i = 0; i < size; i += N) {
+    aie::accum<accfloat, N> scaled = aie::mul(aie::load_v<N>(out + i), invSum);
+    aie::store_v(out + i, scaled.to_vector<bfloat16>());
+  }
+}
 }
 #endif //__LUT_BASED_OPS_H__
@@ -294,4 +294,130 @@ inline __attribute__((always_inline)) v32bfloat16 getFloorBf16(v32bfloat16 in) {
       sel(in_accfloat.to_vector<bfloat16>(), in, cmp);
   return (v32bfloat16)out;
 }
+
+// Compute log(x) by splitting x into 2^e * m, with m in [1, 2), so that
+// log(x) = e * ln(2) + log(1 + t) and t = m - 1 in [0, 1). log(1 + t) is
+// approximated by t * P(t) with the degree 4 polynomial from Abramowitz &
+// Stegun 4.1.44 (|error| <= 1e-5, well below bf16 precision).
+// Special inputs follow std::log: +-0 gives -inf, negative inputs give NaN,
+// +inf gives +inf and NaN is propagated. Denormals are flushed to zero, like
+// the rest of the bf16 arithmetic, so they also give -inf.
+inline __attribute__((always_inline)) v16bfloat16 getLogBf16(v16bfloat16 in) {
+  constexpr bfloat16 A1 = 0.99949556;
+  constexpr bfloat16 A2 = -0.49190896;
+  constexpr bfloat16 A3 = 0.28947478;
+  constexpr bfloat16 A4 = -0.13606275;
+  constexpr bfloat16 A5 = 0.03215845;
+  constexpr bfloat16 ln2 = 0.69314718;
+  constexpr bfloat16 one = 1.0;
+  aie::vector<bfloat16, 16> x = in;
+  aie::vector<int16, 16> bits = x.cast_to<int16>();
+
+  // unbiased exponent e and mantissa m, rebased to the exponent of 1.0
+  aie::vector<int16, 16> e =
+      aie::sub(aie::downshift(bits, 7), aie::broadcast<int16, 16>(127));
+  aie::vector<int16, 16> mBits =
+      aie::bit_or(aie::bit_and(bits, aie::broadcast<int16, 16>(0x7f)),
+                  aie::broadcast<int16, 16>(0x3f80));
+  aie::vector<bfloat16, 16> t = aie::sub(mBits.cast_to<bfloat16>(), one);
+
+  // P(t) = A1 + t * (A2 + t * (A3 + t * (A4 + t * A5)))
+  aie::accum<accfloat, 16> acc = aie::mul(t, A5);
+  aie::vector<bfloat16, 16> p = aie::add(acc.to_vector<bfloat16>(), A4);
+  acc = aie::mul(p, t);
+  p = aie::add(acc.to_vector<bfloat16>(), A3);
+  acc = aie::mul(p, t);
+  p = aie::add(acc.to_vector<bfloat16>(), A2);
+  acc = aie::mul(p, t);
+  p = aie::add(acc.to_vector<bfloat16>(), A1);
+
+  // e * ln(2) + t * P(t)
+  aie::accum<accfloat, 16> eFloat =
+      v16accfloat(aie::to_float(aie::unpack(e), 0));
+  acc = aie::mul(eFloat.to_vector<bfloat16>(), ln2);
+  acc = aie::mac(acc, p, t);
+  aie::vector<bfloat16, 16> out = acc.to_vector<bfloat16>();
+
+  // special inputs, told apart by their exponent and sign bits
+  aie::vector<int16, 16> expBits =
+      aie::bit_and(bits, aie::broadcast<int16, 16>(0x7f80));
+  aie::mask<16> isInfOrNaN =
+      aie::eq(expBits, aie::broadcast<int16, 16>(0x7f80));
+  aie::mask<16> isNegative = aie::lt(bits, aie::zeros<int16, 16>());
+  aie::mask<16> isZero = aie::eq(expBits, aie::zeros<int16, 16>());
+  aie::vector<bfloat16, 16> nan =
+      aie::broadcast<int16, 16>(0x7fc0).cast_to<bfloat16>();
+  aie::vector<bfloat16, 16> minusInf =
+      aie::broadcast<int16, 16>(static_cast<int16>(0xff80))
+          .cast_to<bfloat16>();
+  out = aie::select(out, x, isInfOrNaN);
+  out = aie::select(out, nan, isNegative);
+  out = aie::select(out, minusInf, isZero);
+  return (v16bfloat16)out;
+}
+
+inline __attribute__((always_inline)) v32bfloat16 getLogBf16(v32bfloat16 in) {
+  v16bfloat16 out_low = getLogBf16(extract_v16bfloat16(in, 0));
+  v16bfloat16 out_high = getLogBf16(extract_v16bfloat16(in, 1));
+  return concat(out_low, out_high);
+}
+
+// Compute log(1 + x). Near zero, 1 + x drops most of the bits of x in bf16, so
+// for |x| < 0.25 the Maclaurin series x - x^2/2 + x^3/3 - x^4/4 is used
+// instead of getLogBf16(1 + x).
+inline __attribute__((always_inline)) v16bfloat16
+getLog1pBf16(v16bfloat16 in) {
+  constexpr bfloat16 Q2 = -0.5;
+  constexpr bfloat16 Q3 = 0.3333333333;
+  constexpr bfloat16 Q4 = -0.25;
+  constexpr bfloat16 one = 1.0;
+  constexpr bfloat16 threshold = 0.25;
+  aie::vector<bfloat16, 16> x = in;
+  aie::vector<bfloat16, 16> logX = getLogBf16((v16bfloat16)aie::add(x, one));
+
+  // x * (1 + x * (Q2 + x * (Q3 + x * Q4)))
+  aie::accum<accfloat, 16> acc = aie::mul(x, Q4);
+  aie::vector<bfloat16, 16> p = aie::add(acc.to_vector<bfloat16>(), Q3);
+  acc = aie::mul(p, x);
+  p = aie::add(acc.to_vector<bfloat16>(), Q2);
+  acc = aie::mul(p, x);
+  p = aie::add(acc.to_vector<bfloat16>(), one);
+  acc = aie::mul(p, x);
+
+  aie::mask<16> small = aie::lt(aie::abs(x), threshold);
+  aie::vector<bfloat16, 16> out =
+      aie::select(logX, acc.to_vector<bfloat16>(), small);
+  return (v16bfloat16)out;
+}
+
+inline __attribute__((always_inline)) v32bfloat16
+getLog1pBf16(v32bfloat16 in) {
+  v16bfloat16 out_low = getLog1pBf16(extract_v16bfloat16(in, 0));
+  v16bfloat16 out_high = getLog1pBf16(extract_v16bfloat16(in, 1));
+  return concat(out_low, out_high);
+}
+
+// Compute gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+inline __attribute__((always_inline)) v16bfloat16
+getGeluErfBf16(v16bfloat16 in) {
+  constexpr bfloat16 invSqrt2 = 0.7071067811865476;
+  constexpr bfloat16 half = 0.5;
+  constexpr bfloat16 one = 1.0;
+  aie::vector<bfloat16, 16> x = in;
+  aie::accum<accfloat, 16> acc = aie::mul(x, invSqrt2);
+  aie::vector<bfloat16, 16> erfX =
+      getErfBf16((v16bfloat16)acc.to_vector<bfloat16>());
+  aie::vector<bfloat16, 16> s = aie::add(erfX, one);
+  acc = aie::mul(x, half);
+  acc = aie::mul(acc.to_vector<bfloat16>(), s);
+  aie::vector<bfloat16, 16> out = acc.to_vector<bfloat16>();
+  return (v16bfloat16)out;
+}
+
+inline __attribute__((always_inline)) v32bfloat16
+getGeluErfBf16(v32bfloat16 in) {
+  v16bfloat16 out_low = getGeluErfBf16(extract_v16bfloat16(in, 0));
+  v16bfloat16 out_high = getGeluErfBf16(extract_v16bfloat16(in, 1));
+  return concat(out_low, out_high);
+}
 #endif // VEC_MATH_H
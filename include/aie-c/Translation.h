@@ -26,14 +26,38 @@ MLIR_CAPI_EXPORTED MlirStringRef
 aieTranslateControlPacketsToUI32Vec(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToXAIEV2(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToHSA(MlirOperation op);
+MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToLdScript(MlirOperation op,
+                                                        int col, int row);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToBCF(MlirOperation op, int col,
                                                    int row);
 MLIR_CAPI_EXPORTED MlirStringRef aieLLVMLink(MlirStringRef *modules,
                                              int nModules);
+/** Like aieLLVMLink, but afterwards removes the functions and globals that
+ * the definitions of the first module cannot reach. What was removed, and
+ * the data memory that frees, is returned in report.
+ */
+MLIR_CAPI_EXPORTED MlirStringRef aieLLVMLinkPruned(MlirStringRef *modules,
+                                                   int nModules,
+                                                   MlirStringRef *report);
+/** Runs a textual pass pipeline on op. Parse errors are printed to stderr,
+ * errors from the passes go to the diagnostic handler of the context.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult aieRunPassPipeline(MlirOperation op,
+                                                        MlirStringRef pipeline);
+/** Like aieRunPassPipeline, but also returns a report of the wall time
+ * spent in each pass and the op counts before and after the pipeline, one
+ * tab separated record per line:
+ *   pass <name> <seconds>
+ *   op <name> <count before> <count after>
+ * Returns a null string if the pipeline fails to parse or run.
+ */
+MLIR_CAPI_EXPORTED MlirStringRef
+aieRunPassPipelineWithReport(MlirOperation op, MlirStringRef pipeline);
 MLIR_CAPI_EXPORTED MlirLogicalResult
 aieTranslateToCDODirect(MlirOperation moduleOp, MlirStringRef workDirPath,
                         bool bigEndian, bool emitUnified, bool cdoDebug,
-                        bool aieSim, bool xaieDebug, bool enableCores);
+                        bool aieSim, bool xaieDebug, bool enableCores,
+                        bool parallelColumns);
 MLIR_CAPI_EXPORTED MlirOperation aieTranslateBinaryToTxn(MlirContext ctx,
                                                          MlirStringRef binary);
 
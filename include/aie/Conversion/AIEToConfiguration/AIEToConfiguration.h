@@ -26,9 +26,15 @@ createConvertAIEToTransactionPass();
 std::unique_ptr<mlir::OperationPass<xilinx::AIE::DeviceOp>>
 createConvertAIEToControlPacketsPass();
 
+std::unique_ptr<mlir::OperationPass<xilinx::AIE::DeviceOp>>
+createAIEPackControlPacketsPass();
+
+// Decode a transaction binary into a new module. Operations are emitted as
+// they are decoded, and runs of writes to consecutive addresses are coalesced
+// into npu.blockwrite ops.
 std::optional<mlir::ModuleOp>
 convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
-                               std::vector<uint8_t> &binary);
+                               llvm::ArrayRef<uint8_t> binary);
 
 } // namespace xilinx::AIE
 
@@ -50,6 +50,14 @@ struct CanonicalizeVectorForAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<unsigned> reductionAccumulators{
+      *this, "reduction-accumulators",
+      llvm::cl::desc("Number of independent accumulators loop-carried vector "
+                     "reductions are split into on AIE2. Floating-point add "
+                     "and mul reductions are only split if they allow "
+                     "reassociation. The default of 1 leaves reductions "
+                     "alone."),
+      llvm::cl::init(1)};
 };
 
 /// Options for the "lower-vector-to-aievec" pipeline.
@@ -88,6 +96,16 @@ struct OptimizeAIEVecOptions
       llvm::cl::init(0)};
 };
 
+/// Options for the "affine-vectorize-for-aievec" pipeline.
+struct AffineVectorizeForAIEVecOptions
+    : public mlir::PassPipelineOptions<AffineVectorizeForAIEVecOptions> {
+  PassOptions::Option<std::string> aieTarget{
+      *this, "aie-target",
+      llvm::cl::desc("Select AIE version: \"aie2\" or \"aie2p\". This will "
+                     "determine the cost model used to pick vector widths."),
+      llvm::cl::init("aie2")};
+};
+
 /// Options for the "convert-vector-to-aievec" pipeline.
 struct ConvertVectorToAIEVecOptions
     : public mlir::PassPipelineOptions<ConvertVectorToAIEVecOptions> {
@@ -118,6 +136,14 @@ struct ConvertVectorToAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<unsigned> reductionAccumulators{
+      *this, "reduction-accumulators",
+      llvm::cl::desc("Number of independent accumulators loop-carried vector "
+                     "reductions are split into on AIE2. Floating-point add "
+                     "and mul reductions are only split if they allow "
+                     "reassociation. The default of 1 leaves reductions "
+                     "alone."),
+      llvm::cl::init(1)};
 
   mlir::LogicalResult parseFromString(mlir::StringRef options) {
     auto res = PassPipelineOptions::parseFromString(options);
@@ -126,6 +152,7 @@ struct ConvertVectorToAIEVecOptions
       lowerOptions.targetBackend = targetBackend;
       canonicalizeOptions.aieTarget = aieTarget;
       canonicalizeOptions.targetBackend = targetBackend;
+      canonicalizeOptions.reductionAccumulators = reductionAccumulators;
       optimizeOptions.aieTarget = aieTarget;
       optimizeOptions.targetBackend = targetBackend;
       optimizeOptions.shiftParam = shiftParam;
@@ -163,6 +190,13 @@ private:
 void buildConvertVectorToAIEVec(mlir::OpPassManager &pm,
                                 const ConvertVectorToAIEVecOptions &options);
 
+/// Adds the "affine-vectorize-for-aievec" pipeline to the `OpPassManager`.
+/// This pipeline vectorizes the innermost parallel affine loops, choosing the
+/// vector width of each loop by the estimated throughput of the target AIE
+/// vector unit. Its output is meant to be fed to "convert-vector-to-aievec".
+void buildAffineVectorizeForAIEVec(
+    mlir::OpPassManager &pm, const AffineVectorizeForAIEVecOptions &options);
+
 void buildCanonicalizeVectorForAIEVec(
     mlir::OpPassManager &pm, const CanonicalizeVectorForAIEVecOptions &options);
 
@@ -178,6 +212,11 @@ void registerAIEVecPipelines();
 /// Create a pass that removes unnecessary Copy operations.
 std::unique_ptr<::mlir::Pass> createCopyRemovalPass();
 
+/// Create a pass that keeps loop-carried reductions in vector accumulators,
+/// splitting each one into `numAccumulators` independent partial accumulators.
+std::unique_ptr<::mlir::Pass>
+createSplitReductionAccumulatorsPass(unsigned numAccumulators);
+
 // Create a pass that rewrites the arith dialect to enable the support of
 // dynamic sized tensor/memref for the auto-vectorization to CPP flow.
 std::unique_ptr<::mlir::Pass> createDynamicSizeNoImplicitBroadcastPass();
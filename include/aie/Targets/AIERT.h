@@ -190,10 +190,34 @@ static_assert(XAIE_OK == 0);
 #define BASE_ADDR_A_INCR_EAST 0x100000
 
 namespace xilinx::AIE {
+
+// How a register is treated when register writes are deduplicated, reordered
+// or diffed against another configuration.
+enum class RegisterKind {
+  // Written by configuration only and not changed while a design runs, with
+  // no effect until a DMA task is started: stream switch ports, core and
+  // memtile DMA buffer descriptors, and the shim mux/demux.
+  Config,
+  // Core program memory.
+  Program,
+  // Everything else: data memory and locks change while the design runs,
+  // shim DMAs are reprogrammed by the runtime sequence, and writes to DMA
+  // channel control, task queues or core control have side effects.
+  Volatile,
+};
+
+// Classify the register at address 'addr', as used in transactions.
+RegisterKind getRegisterKind(const AIETargetModel &tm, uint64_t addr);
+
 struct AIERTControl {
   XAie_Config configPtr;
   XAie_DevInst devInst;
   const BaseNPUTargetModel &targetModel;
+  // Set while this thread records a transaction started by startTransaction().
+  bool inTransaction = false;
+  // Pass the init config through addOptimizedWrites(). Off by default, as it
+  // changes the order of the emitted writes.
+  bool optimizeWrites = false;
 
   AIERTControl(const xilinx::AIE::BaseNPUTargetModel &tm);
 
@@ -212,17 +236,36 @@ struct AIERTControl {
   mlir::LogicalResult initBuffers(DeviceOp &targetOp);
   mlir::LogicalResult configureSwitches(DeviceOp &targetOp);
   mlir::LogicalResult addInitConfig(DeviceOp &targetOp);
+  // addInitConfig() without the write optimization.
+  mlir::LogicalResult addInitConfigWrites(DeviceOp &targetOp);
   mlir::LogicalResult addCoreEnable(DeviceOp &targetOp);
   mlir::LogicalResult configureLocksInBdBlock(XAie_DmaDesc &dmaTileBd,
                                               mlir::Block &block,
                                               XAie_LocType &tileLoc);
   mlir::LogicalResult addAieElf(uint8_t col, uint8_t row,
                                 const mlir::StringRef elfPath, bool aieSim);
+  // Load the ELFs of all cores, or only of the cores in column 'col'.
   mlir::LogicalResult addAieElfs(DeviceOp &targetOp,
                                  const mlir::StringRef workDirPath,
-                                 bool aieSim);
+                                 bool aieSim,
+                                 std::optional<int> col = std::nullopt);
+  // Reissue the register writes recorded in 'txn' through this instance's
+  // IO backend.
+  mlir::LogicalResult replayTransaction(const XAie_TxnInst &txn);
+  mlir::LogicalResult replayCommands(llvm::ArrayRef<XAie_TxnCmd> cmds);
+  // Run 'addWrites' and issue the register writes it makes through a shadow
+  // copy of the configuration registers: writes of values already held are
+  // dropped, masked writes to one word are merged, and configuration writes
+  // between side-effecting ones are sorted by address within each tile so
+  // that they coalesce into block writes. Within a transaction, this is left
+  // to optimizeTransaction().
+  mlir::LogicalResult
+  addOptimizedWrites(llvm::function_ref<mlir::LogicalResult()> addWrites);
+  // Apply the same optimization to the transaction being recorded.
+  mlir::LogicalResult optimizeTransaction();
   void startTransaction();
   void dmaUpdateBdAddr(int col, int row, size_t addr, size_t bdId);
+  // Print the transaction being recorded and end it.
   void exportSerializedTransaction();
 };
 
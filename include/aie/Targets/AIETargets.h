@@ -52,17 +52,27 @@ mlir::LogicalResult AIETranslateToLdScript(mlir::ModuleOp module,
 mlir::LogicalResult AIETranslateToBCF(mlir::ModuleOp module,
                                       llvm::raw_ostream &output, int tileCol,
                                       int tileRow);
+// If PruneReport is given, functions and globals that the definitions of the
+// first file cannot reach are removed after linking, and what was removed is
+// written to PruneReport.
 mlir::LogicalResult
 AIELLVMLink(llvm::raw_ostream &output, std::vector<std::string> Files,
             bool DisableDITypeMap = false, bool NoVerify = false,
             bool Internalize = false, bool OnlyNeeded = false,
-            bool PreserveAssemblyUseListOrder = false, bool Verbose = false);
+            bool PreserveAssemblyUseListOrder = false, bool Verbose = false,
+            llvm::raw_ostream *PruneReport = nullptr);
 
+// If parallelColumns is set, the ELFs of each column are loaded concurrently
+// with separate libxaie instances and merged in column order. If
+// optimizeWrites is set, redundant init config writes are dropped and the
+// rest are batched into block writes per tile.
 mlir::LogicalResult
 AIETranslateToCDODirect(mlir::ModuleOp m, llvm::StringRef workDirPath,
                         bool bigEndian = false, bool emitUnified = false,
                         bool cdoDebug = false, bool aieSim = false,
-                        bool xaieDebug = false, bool enableCores = true);
+                        bool xaieDebug = false, bool enableCores = true,
+                        bool parallelColumns = false,
+                        bool optimizeWrites = false);
 
 #ifdef AIE_ENABLE_AIRBIN
 mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
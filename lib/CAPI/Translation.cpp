@@ -20,15 +20,22 @@
 #include "mlir/CAPI/IR.h"
 #include "mlir/CAPI/Support.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -67,11 +74,12 @@ MlirLogicalResult aieTranslateToCDODirect(MlirOperation moduleOp,
                                           MlirStringRef workDirPath,
                                           bool bigEndian, bool emitUnified,
                                           bool cdoDebug, bool aieSim,
-                                          bool xaieDebug, bool enableCores) {
+                                          bool xaieDebug, bool enableCores,
+                                          bool parallelColumns) {
   ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
   auto status = AIETranslateToCDODirect(
       mod, llvm::StringRef(workDirPath.data, workDirPath.length), bigEndian,
-      emitUnified, cdoDebug, aieSim, xaieDebug, enableCores);
+      emitUnified, cdoDebug, aieSim, xaieDebug, enableCores, parallelColumns);
   std::vector<std::string> diagnostics;
   ScopedDiagnosticHandler handler(mod.getContext(), [&](Diagnostic &d) {
     llvm::raw_string_ostream(diagnostics.emplace_back())
@@ -85,7 +93,8 @@ MlirLogicalResult aieTranslateToCDODirect(MlirOperation moduleOp,
 }
 
 MlirOperation aieTranslateBinaryToTxn(MlirContext ctx, MlirStringRef binary) {
-  std::vector<uint8_t> binaryData(binary.data, binary.data + binary.length);
+  llvm::ArrayRef<uint8_t> binaryData(
+      reinterpret_cast<const uint8_t *>(binary.data), binary.length);
   auto mod = convertTransactionBinaryToMLIR(unwrap(ctx), binaryData);
   if (!mod)
     return wrap(ModuleOp().getOperation());
@@ -136,6 +145,18 @@ MlirStringRef aieTranslateToHSA(MlirOperation moduleOp) {
   return mlirStringRefCreate(cStr, xaie.size());
 }
 
+MlirStringRef aieTranslateToLdScript(MlirOperation moduleOp, int col,
+                                     int row) {
+  std::string ldscript;
+  llvm::raw_string_ostream os(ldscript);
+  ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
+  if (failed(AIETranslateToLdScript(mod, os, col, row)))
+    return mlirStringRefCreate(nullptr, 0);
+  char *cStr = static_cast<char *>(malloc(ldscript.size()));
+  ldscript.copy(cStr, ldscript.size());
+  return mlirStringRefCreate(cStr, ldscript.size());
+}
+
 MlirStringRef aieTranslateToBCF(MlirOperation moduleOp, int col, int row) {
   std::string bcf;
   llvm::raw_string_ostream os(bcf);
@@ -161,6 +182,29 @@ MlirStringRef aieLLVMLink(MlirStringRef *modules, int nModules) {
   return mlirStringRefCreate(cStr, ll.size());
 }
 
+MlirStringRef aieLLVMLinkPruned(MlirStringRef *modules, int nModules,
+                                MlirStringRef *report) {
+  std::string ll, pruned;
+  llvm::raw_string_ostream os(ll), reportOs(pruned);
+  std::vector<std::string> files;
+  files.reserve(nModules);
+  for (int i = 0; i < nModules; ++i)
+    files.emplace_back(modules[i].data, modules[i].length);
+  *report = mlirStringRefCreate(nullptr, 0);
+  if (failed(AIELLVMLink(os, files, /*DisableDITypeMap=*/false,
+                         /*NoVerify=*/false, /*Internalize=*/false,
+                         /*OnlyNeeded=*/false,
+                         /*PreserveAssemblyUseListOrder=*/false,
+                         /*Verbose=*/false, &reportOs)))
+    return mlirStringRefCreate(nullptr, 0);
+  char *reportStr = static_cast<char *>(malloc(pruned.size()));
+  pruned.copy(reportStr, pruned.size());
+  *report = mlirStringRefCreate(reportStr, pruned.size());
+  char *cStr = static_cast<char *>(malloc(ll.size()));
+  ll.copy(cStr, ll.size());
+  return mlirStringRefCreate(cStr, ll.size());
+}
+
 DEFINE_C_API_PTR_METHODS(AieRtControl, xilinx::AIE::AIERTControl)
 
 AieRtControl getAieRtControl(AieTargetModel tm) {
@@ -190,4 +234,98 @@ void aieRtStartTransaction(AieRtControl aieCtl) {
 void aieRtExportSerializedTransaction(AieRtControl aieCtl) {
   AIERTControl *ctl = unwrap(aieCtl);
   ctl->exportSerializedTransaction();
-}
\ No newline at end of file
+}
+
+namespace {
+// Accumulates the wall time spent in each pass, by pass argument. Nested
+// pipelines may run on several threads, so the bookkeeping is locked.
+struct PassTimes : PassInstrumentation {
+  using Clock = std::chrono::steady_clock;
+  llvm::sys::SmartMutex<true> mutex;
+  DenseMap<std::pair<Pass *, Operation *>, Clock::time_point> running;
+  MapVector<StringRef, double> seconds;
+
+  void runBeforePass(Pass *pass, Operation *op) override {
+    llvm::sys::SmartScopedLock<true> lock(mutex);
+    running[{pass, op}] = Clock::now();
+  }
+  void runAfterPass(Pass *pass, Operation *op) override { stop(pass, op); }
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    stop(pass, op);
+  }
+  void stop(Pass *pass, Operation *op) {
+    Clock::time_point end = Clock::now();
+    llvm::sys::SmartScopedLock<true> lock(mutex);
+    auto it = running.find({pass, op});
+    if (it == running.end())
+      return;
+    double elapsed = std::chrono::duration<double>(end - it->second).count();
+    running.erase(it);
+    // Every pass of a parsed pipeline has an argument. The ones without are
+    // the adaptors that run nested pipelines, whose time is already counted
+    // by the passes they run.
+    StringRef name = pass->getArgument();
+    if (name.empty())
+      return;
+    seconds[name] += elapsed;
+  }
+};
+} // namespace
+
+// Count the ops nested in root by name, into the first or second entry.
+static void countOps(Operation *root,
+                     MapVector<StringRef, std::pair<int, int>> &counts,
+                     bool after) {
+  root->walk([&](Operation *op) {
+    auto &count = counts[op->getName().getStringRef()];
+    (after ? count.second : count.first)++;
+  });
+}
+
+// Parse a textual pass pipeline into pm. Parse errors go to stderr.
+static LogicalResult parsePipeline(MlirStringRef pipeline, PassManager &pm) {
+  FailureOr<OpPassManager> parsed =
+      parsePassPipeline(unwrap(pipeline), llvm::errs());
+  if (failed(parsed))
+    return failure();
+  static_cast<OpPassManager &>(pm) = std::move(*parsed);
+  return success();
+}
+
+MlirLogicalResult aieRunPassPipeline(MlirOperation mlirOp,
+                                     MlirStringRef pipeline) {
+  Operation *op = unwrap(mlirOp);
+  PassManager pm(op->getContext());
+  if (failed(parsePipeline(pipeline, pm)))
+    return wrap(failure());
+  return wrap(pm.run(op));
+}
+
+MlirStringRef aieRunPassPipelineWithReport(MlirOperation mlirOp,
+                                           MlirStringRef pipeline) {
+  Operation *op = unwrap(mlirOp);
+  PassManager pm(op->getContext());
+  if (failed(parsePipeline(pipeline, pm)))
+    return mlirStringRefCreate(nullptr, 0);
+  auto times = std::make_unique<PassTimes>();
+  PassTimes &passTimes = *times;
+  pm.addInstrumentation(std::move(times));
+
+  MapVector<StringRef, std::pair<int, int>> counts;
+  countOps(op, counts, /*after=*/false);
+  if (failed(pm.run(op)))
+    return mlirStringRefCreate(nullptr, 0);
+  countOps(op, counts, /*after=*/true);
+
+  std::string report;
+  llvm::raw_string_ostream os(report);
+  for (auto &[name, seconds] : passTimes.seconds)
+    os << "pass\t" << name << "\t" << llvm::format("%.6f", seconds) << "\n";
+  for (auto &[name, count] : counts)
+    os << "op\t" << name << "\t" << count.first << "\t" << count.second
+       << "\n";
+  os.flush();
+  char *cStr = static_cast<char *>(malloc(report.size()));
+  report.copy(cStr, report.size());
+  return mlirStringRefCreate(cStr, report.size());
+}
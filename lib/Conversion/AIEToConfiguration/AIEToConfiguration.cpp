@@ -13,8 +13,11 @@
 #include "aie/Conversion/AIEToConfiguration/AIEToConfiguration.h"
 #include "aie/Targets/AIERT.h"
 
+#include "mlir/Parser/Parser.h"
+
 #include "llvm/Support/Debug.h"
 
+#include <map>
 #include <vector>
 
 #define DEBUG_TYPE "aie-convert-to-config"
@@ -39,32 +42,70 @@ struct TransactionBinaryOperation {
     cmd.Size = size;
   }
 };
+
+// The fixed 16 byte header at the start of a TXN binary.
+struct TransactionBinaryHeader {
+  uint32_t major;
+  uint32_t minor;
+  uint32_t devGen;
+  uint32_t numRows;
+  uint32_t numCols;
+  uint32_t numMemTileRows;
+  uint32_t numOps;
+  uint32_t txnSize;
+};
+
+using TransactionOpCallback =
+    llvm::function_ref<LogicalResult(const TransactionBinaryOperation &)>;
+
 } // namespace
 
-// Parse a TXN binary blob. On success return the number of columns from the
-// header and a vector of parsed operations. On failure return std::nullopt.
-static std::optional<int>
-parseTransactionBinary(const std::vector<uint8_t> &data,
-                       std::vector<TransactionBinaryOperation> &ops) {
-
-  uint32_t major = data[0];
-  uint32_t minor = data[1];
-  uint32_t num_cols = data[4];
-
-  uint32_t num_ops, txn_size;
-  std::memcpy(&num_ops, &data[8], 4);
-  std::memcpy(&txn_size, &data[12], 4);
-
-  LLVM_DEBUG(llvm::dbgs() << "Major: " << major << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "Minor: " << minor << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "DevGen: " << data[2] << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "NumRows: " << data[3] << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "NumCols: " << num_cols << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "NumMemTileRows: " << data[5] << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "NumOps: " << num_ops << "\n");
-  LLVM_DEBUG(llvm::dbgs() << "TxnSize: " << txn_size << " bytes\n");
+// Parse the header of a TXN binary blob. On failure return std::nullopt.
+static std::optional<TransactionBinaryHeader>
+parseTransactionHeader(ArrayRef<uint8_t> data) {
+  if (data.size() < 16) {
+    llvm::errs() << "TXN binary is too small to contain a header\n";
+    return std::nullopt;
+  }
 
-  size_t i = 16;
+  TransactionBinaryHeader hdr;
+  hdr.major = data[0];
+  hdr.minor = data[1];
+  hdr.devGen = data[2];
+  hdr.numRows = data[3];
+  hdr.numCols = data[4];
+  hdr.numMemTileRows = data[5];
+  std::memcpy(&hdr.numOps, &data[8], 4);
+  std::memcpy(&hdr.txnSize, &data[12], 4);
+
+  LLVM_DEBUG(llvm::dbgs() << "Major: " << hdr.major << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "Minor: " << hdr.minor << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "DevGen: " << hdr.devGen << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "NumRows: " << hdr.numRows << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "NumCols: " << hdr.numCols << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "NumMemTileRows: " << hdr.numMemTileRows << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "NumOps: " << hdr.numOps << "\n");
+  LLVM_DEBUG(llvm::dbgs() << "TxnSize: " << hdr.txnSize << " bytes\n");
+
+  if (!(hdr.major == 0 && hdr.minor == 1) &&
+      !(hdr.major == 1 && hdr.minor == 0)) {
+    llvm::errs() << "Unsupported TXN binary version: " << hdr.major << "."
+                 << hdr.minor << "\n";
+    return std::nullopt;
+  }
+  return hdr;
+}
+
+// Decode the operations of a TXN binary blob in order, handing each one to
+// 'emit' as soon as it is decoded. Blockwrite payloads point into 'data', so
+// nothing is copied and no list of operations is built. There are two
+// versions supported, 0.1 and 1.0.
+static LogicalResult parseTransactionBinary(ArrayRef<uint8_t> data,
+                                            TransactionOpCallback emit) {
+  auto hdr = parseTransactionHeader(data);
+  if (!hdr)
+    return failure();
+  bool isV0 = hdr->major == 0;
 
   // Convert opcode from uint8 to enum
   auto convertOpcode = [](uint8_t opc) {
@@ -81,108 +122,88 @@ parseTransactionBinary(const std::vector<uint8_t> &data,
     }
   };
 
-  // Parse the binary blob. There are two versions supported, 0.1 and 1.0.
-  // For both versions, build a list of TransactionBinaryOperation objects
-  // representing the parsed operations.
-  if (major == 0 && minor == 1) {
-    while (i < data.size()) {
-
-      XAie_TxnOpcode opc = convertOpcode(data[i]);
-      LLVM_DEBUG(llvm::dbgs() << "opcode: " + std::to_string(opc) + "\n");
-
-      uint64_t addr = 0;
-      uint32_t value = 0;
-      uint32_t size = 0;
-      uint32_t mask = 0;
-      const uint8_t *data_ptr = nullptr;
-
-      if (opc == XAie_TxnOpcode::XAIE_IO_WRITE) {
-        LLVM_DEBUG(llvm::dbgs() << "opcode: WRITE (0x00)\n");
-        uint32_t addr0, addr1;
-        std::memcpy(&addr0, &data[i + 8], 4);
-        std::memcpy(&addr1, &data[i + 12], 4);
-        std::memcpy(&value, &data[i + 16], 4);
-        std::memcpy(&size, &data[i + 20], 4);
-        addr = static_cast<uint64_t>(addr1) << 32 | addr0;
-        i += size;
-      } else if (opc == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
-        LLVM_DEBUG(llvm::dbgs() << "opcode: BLOCKWRITE (0x01)\n");
-        std::memcpy(&addr, &data[i + 8], 4);
-        std::memcpy(&size, &data[i + 12], 4);
-        data_ptr = data.data() + i + 16;
-        i += size;
-        size = size - 16;
-      } else if (opc == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
-        LLVM_DEBUG(llvm::dbgs() << "opcode: MASKWRITE (0x03)\n");
-        uint32_t addr0, addr1;
-        std::memcpy(&addr0, &data[i + 8], 4);
-        std::memcpy(&addr1, &data[i + 12], 4);
-        std::memcpy(&value, &data[i + 16], 4);
-        std::memcpy(&mask, &data[i + 20], 4);
-        std::memcpy(&size, &data[i + 24], 4);
-        addr = static_cast<uint64_t>(addr1) << 32 | addr0;
-        i += size;
+  size_t i = 16;
+  auto read32 = [&](size_t offset) {
+    uint32_t word;
+    std::memcpy(&word, &data[i + offset], 4);
+    return word;
+  };
+
+  while (i < data.size()) {
+    XAie_TxnOpcode opc = convertOpcode(data[i]);
+    LLVM_DEBUG(llvm::dbgs() << "opcode: " + std::to_string(opc) + "\n");
+
+    uint64_t addr = 0;
+    uint32_t value = 0;
+    uint32_t size = 0;
+    uint32_t mask = 0;
+    const uint8_t *data_ptr = nullptr;
+
+    // Size in bytes of the fixed part of the operation.
+    size_t fixedSize;
+    if (opc == XAie_TxnOpcode::XAIE_IO_WRITE)
+      fixedSize = isV0 ? 24 : 12;
+    else if (opc == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE)
+      fixedSize = isV0 ? 16 : 12;
+    else if (opc == XAie_TxnOpcode::XAIE_IO_MASKWRITE)
+      fixedSize = isV0 ? 28 : 16;
+    else
+      return failure();
+    if (i + fixedSize > data.size()) {
+      llvm::errs() << "Truncated TXN binary at offset " << i << "\n";
+      return failure();
+    }
+
+    // Size in bytes of the whole operation.
+    size_t opSize = fixedSize;
+    if (opc == XAie_TxnOpcode::XAIE_IO_WRITE) {
+      LLVM_DEBUG(llvm::dbgs() << "opcode: WRITE (0x00)\n");
+      if (isV0) {
+        addr = static_cast<uint64_t>(read32(12)) << 32 | read32(8);
+        value = read32(16);
+        size = read32(20);
+        opSize = size;
       } else {
-        llvm::errs() << "Unhandled opcode: " << std::to_string(opc) << "\n";
-        return std::nullopt;
+        addr = read32(4);
+        value = read32(8);
       }
-      ops.emplace_back(opc, mask, addr, value, data_ptr, size);
-      LLVM_DEBUG(llvm::dbgs() << "addr: " << addr << "\n");
-      LLVM_DEBUG(llvm::dbgs() << "value: " << value << "\n");
-      LLVM_DEBUG(llvm::dbgs() << "size: " << size << "\n");
-      LLVM_DEBUG(llvm::dbgs() << "mask: " << mask << "\n");
-      LLVM_DEBUG(llvm::dbgs()
-                 << "data: " << reinterpret_cast<uintptr_t>(data_ptr) << "\n");
-    }
-  } else if (major == 1 && minor == 0) {
-    while (i < data.size()) {
-
-      XAie_TxnOpcode opc = convertOpcode(data[i]);
-      LLVM_DEBUG(llvm::dbgs() << "opcode: " + std::to_string(opc) + "\n");
-
-      uint64_t addr = 0;
-      uint32_t value = 0;
-      uint32_t size = 0;
-      uint32_t mask = 0;
-      const uint8_t *data_ptr = nullptr;
-
-      if (opc == XAie_TxnOpcode::XAIE_IO_WRITE) {
-        LLVM_DEBUG(llvm::dbgs() << "opcode: WRITE (0x00)\n");
-        std::memcpy(&addr, &data[i + 4], 4);
-        std::memcpy(&value, &data[i + 8], 4);
-        i += 12;
-      } else if (opc == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
-        LLVM_DEBUG(llvm::dbgs() << "opcode: BLOCKWRITE (0x01)\n");
-        std::memcpy(&addr, &data[i + 4], 4);
-        std::memcpy(&size, &data[i + 8], 4);
-        data_ptr = data.data() + i + 12;
-        i += size;
-        size = size - 12;
-      } else if (opc == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
-        LLVM_DEBUG(llvm::dbgs() << "opcode: MASKWRITE (0x03)\n");
-        std::memcpy(&addr, &data[i + 4], 4);
-        std::memcpy(&value, &data[i + 8], 4);
-        std::memcpy(&mask, &data[i + 12], 4);
-        i += 16;
+    } else if (opc == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
+      LLVM_DEBUG(llvm::dbgs() << "opcode: BLOCKWRITE (0x01)\n");
+      addr = read32(isV0 ? 8 : 4);
+      opSize = read32(isV0 ? 12 : 8);
+      data_ptr = data.data() + i + fixedSize;
+      size = opSize - fixedSize;
+    } else {
+      LLVM_DEBUG(llvm::dbgs() << "opcode: MASKWRITE (0x03)\n");
+      if (isV0) {
+        addr = static_cast<uint64_t>(read32(12)) << 32 | read32(8);
+        value = read32(16);
+        mask = read32(20);
+        size = read32(24);
+        opSize = size;
       } else {
-        llvm::errs() << "Unhandled opcode: " << std::to_string(opc) << "\n";
-        return std::nullopt;
+        addr = read32(4);
+        value = read32(8);
+        mask = read32(12);
       }
-      LLVM_DEBUG(llvm::dbgs() << "addr: " << addr << "\n");
-      LLVM_DEBUG(llvm::dbgs() << "value: " << value << "\n");
-      LLVM_DEBUG(llvm::dbgs() << "size: " << size << "\n");
-      LLVM_DEBUG(llvm::dbgs() << "mask: " << mask << "\n");
-      LLVM_DEBUG(llvm::dbgs()
-                 << "data: " << reinterpret_cast<uintptr_t>(data_ptr) << "\n");
-      ops.emplace_back(opc, mask, addr, value, data_ptr, size);
     }
-  } else {
-    llvm::errs() << "Unsupported TXN binary version: " << major << "." << minor
-                 << "\n";
-    return std::nullopt;
-  }
+    if (opSize < fixedSize || i + opSize > data.size()) {
+      llvm::errs() << "Truncated TXN binary at offset " << i << "\n";
+      return failure();
+    }
 
-  return num_cols;
+    LLVM_DEBUG(llvm::dbgs() << "addr: " << addr << "\n");
+    LLVM_DEBUG(llvm::dbgs() << "value: " << value << "\n");
+    LLVM_DEBUG(llvm::dbgs() << "size: " << size << "\n");
+    LLVM_DEBUG(llvm::dbgs() << "mask: " << mask << "\n");
+    LLVM_DEBUG(llvm::dbgs()
+               << "data: " << reinterpret_cast<uintptr_t>(data_ptr) << "\n");
+    if (failed(emit(TransactionBinaryOperation(opc, mask, addr, value,
+                                               data_ptr, size))))
+      return failure();
+    i += opSize;
+  }
+  return success();
 }
 
 static LogicalResult generateTransactions(AIERTControl &ctl,
@@ -201,29 +222,54 @@ static LogicalResult generateTransactions(AIERTControl &ctl,
   return success();
 }
 
-// Translate vector of TransactionBinaryOperation to a sequence of transaction
-// ops (npu.write32, npu.maskwrite32, npu.blockwrite).
-static LogicalResult
-emitTransactionOps(OpBuilder &builder,
-                   std::vector<TransactionBinaryOperation> &operations,
-                   std::vector<memref::GlobalOp> &global_data) {
+// an enum to represent the output type of the transaction binary
+enum OutputType {
+  Transaction,
+  ControlPacket,
+};
 
-  auto loc = builder.getUnknownLoc();
+namespace {
 
-  // create the txn ops
-  for (auto p : llvm::zip(operations, global_data)) {
-    auto op = std::get<0>(p);
-    memref::GlobalOp payload = std::get<1>(p);
+// Builds MLIR ops for transaction operations as they are decoded, so the
+// binary never has to be held as a list of operations.
+//
+// For transaction output, runs of writes to consecutive configuration or
+// program memory registers are coalesced into a single npu.blockwrite.
+// Writes to other registers, e.g. DMA channel control and task queues, locks
+// or core control, are kept as individual write32 ops since the order and
+// width of those writes matter. Blockwrite payloads are stored in
+// memref.global ops that are shared between blockwrites with identical data.
+class TransactionOpEmitter {
+public:
+  TransactionOpEmitter(OpBuilder &builder, AIE::DeviceOp device,
+                       AIEX::RuntimeSequenceOp seq, OutputType outputType)
+      : builder(builder), globalBuilder(seq), symbolTable(device),
+        tm(device.getTargetModel()), outputType(outputType),
+        loc(builder.getUnknownLoc()) {}
+
+  LogicalResult emit(const TransactionBinaryOperation &op) {
+    if (outputType == OutputType::ControlPacket)
+      return emitControlPacket(op);
+
+    if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE &&
+        AIE::getRegisterKind(tm, op.cmd.RegOff) !=
+            AIE::RegisterKind::Volatile) {
+      if (!pendingWrites.empty() &&
+          op.cmd.RegOff != pendingAddr + pendingWrites.size() * 4)
+        flushWrites();
+      if (pendingWrites.empty())
+        pendingAddr = op.cmd.RegOff;
+      pendingWrites.push_back(op.cmd.Value);
+      return success();
+    }
 
+    flushWrites();
     if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE) {
       builder.create<AIEX::NpuWrite32Op>(loc, op.cmd.RegOff, op.cmd.Value,
                                          nullptr, nullptr, nullptr);
     } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
-      auto memref = builder.create<memref::GetGlobalOp>(loc, payload.getType(),
-                                                        payload.getName());
-      builder.create<AIEX::NpuBlockWriteOp>(
-          loc, builder.getUI32IntegerAttr(op.cmd.RegOff), memref.getResult(),
-          nullptr, nullptr, nullptr);
+      const uint32_t *d = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
+      emitBlockWrite(op.cmd.RegOff, ArrayRef<uint32_t>(d, op.cmd.Size / 4));
     } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
       builder.create<AIEX::NpuMaskWrite32Op>(loc, op.cmd.RegOff, op.cmd.Value,
                                              op.cmd.Mask, nullptr, nullptr,
@@ -232,71 +278,231 @@ emitTransactionOps(OpBuilder &builder,
       llvm::errs() << "Unhandled txn opcode: " << op.cmd.Opcode << "\n";
       return failure();
     }
+    return success();
   }
-  return success();
-}
 
-// Translate vector of TransactionBinaryOperation to a sequence of control
-// packet ops.
-static LogicalResult
-emitControlPacketOps(OpBuilder &builder,
-                     std::vector<TransactionBinaryOperation> &operations,
-                     std::vector<memref::GlobalOp> &global_data) {
+  // Emit anything still buffered. Must be called after the last operation.
+  void finish() { flushWrites(); }
 
-  auto loc = builder.getUnknownLoc();
-  auto ctx = builder.getContext();
+private:
+  void flushWrites() {
+    if (pendingWrites.size() == 1)
+      builder.create<AIEX::NpuWrite32Op>(loc, pendingAddr, pendingWrites[0],
+                                         nullptr, nullptr, nullptr);
+    else if (pendingWrites.size() > 1)
+      emitBlockWrite(pendingAddr, pendingWrites);
+    pendingWrites.clear();
+  }
 
-  // create the control packet ops
-  for (auto p : llvm::zip(operations, global_data)) {
-    auto op = std::get<0>(p);
-    memref::GlobalOp payload = std::get<1>(p);
+  void emitBlockWrite(uint64_t addr, ArrayRef<uint32_t> data) {
+    memref::GlobalOp global = getOrCreateGlobal(data);
+    auto memref = builder.create<memref::GetGlobalOp>(loc, global.getType(),
+                                                      global.getName());
+    builder.create<AIEX::NpuBlockWriteOp>(loc, builder.getUI32IntegerAttr(addr),
+                                          memref.getResult(), nullptr, nullptr,
+                                          nullptr);
+  }
 
-    if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE) {
+  memref::GlobalOp getOrCreateGlobal(ArrayRef<uint32_t> data) {
+    int64_t size = data.size();
+    MemRefType memrefType = MemRefType::get({size}, builder.getI32Type());
+    TensorType tensorType = RankedTensorType::get({size}, builder.getI32Type());
+    auto initVal = DenseElementsAttr::get<uint32_t>(tensorType, data);
+    // DenseElementsAttr are uniqued, so identical payloads compare equal.
+    auto it = globals.find(initVal);
+    if (it != globals.end())
+      return it->second;
+
+    auto global = globalBuilder.create<memref::GlobalOp>(
+        loc, "blockwrite_data", globalBuilder.getStringAttr("private"),
+        memrefType, initVal, true, nullptr);
+    symbolTable.insert(global);
+    globals[initVal] = global;
+    return global;
+  }
+
+  LogicalResult emitControlPacket(const TransactionBinaryOperation &op) {
+    auto ctx = builder.getContext();
+    if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE ||
+        op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
       builder.create<AIEX::NpuControlPacketOp>(
           loc, builder.getUI32IntegerAttr(op.cmd.RegOff), nullptr,
           /*opcode*/ builder.getI32IntegerAttr(0),
           /*stream_id*/ builder.getI32IntegerAttr(0),
           DenseI32ArrayAttr::get(ctx, ArrayRef<int32_t>(op.cmd.Value)));
     } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
-      if (!std::get<1>(p).getInitialValue())
-        continue;
-      auto blockWriteData =
-          dyn_cast<DenseIntElementsAttr>(*std::get<1>(p).getInitialValue());
-      if (!blockWriteData) {
-        payload.emitError(
-            "Global symbol initial value is not a dense int array");
-        break;
-      }
-      auto blockWriteDataValues = blockWriteData.getValues<int32_t>();
+      const int32_t *d = reinterpret_cast<const int32_t *>(op.cmd.DataPtr);
+      ArrayRef<int32_t> blockWriteData(d, op.cmd.Size / 4);
       // Split block write data into beats of 4 or less, in int32_t.
       int currAddr = op.cmd.RegOff;
-      for (size_t i = 0; i < blockWriteDataValues.size(); i += 4) {
-        auto last = std::min(blockWriteDataValues.size(), i + 4);
-        SmallVector<int32_t> splitData =
-            SmallVector<int32_t>(blockWriteDataValues.begin() + i,
-                                 blockWriteDataValues.begin() + last);
+      for (size_t i = 0; i < blockWriteData.size(); i += 4) {
+        auto splitData = blockWriteData.slice(
+            i, std::min<size_t>(4, blockWriteData.size() - i));
         builder.create<AIEX::NpuControlPacketOp>(
             loc, builder.getUI32IntegerAttr(currAddr), nullptr,
             /*opcode*/ builder.getI32IntegerAttr(0),
             /*stream_id*/ builder.getI32IntegerAttr(0),
-            DenseI32ArrayAttr::get(ctx, ArrayRef<int32_t>(splitData)));
+            DenseI32ArrayAttr::get(ctx, splitData));
         currAddr += splitData.size() * sizeof(int32_t);
       }
-
-    } else if (op.cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
-      builder.create<AIEX::NpuControlPacketOp>(
-          loc, builder.getUI32IntegerAttr(op.cmd.RegOff), nullptr,
-          /*opcode*/ builder.getI32IntegerAttr(0),
-          /*stream_id*/ builder.getI32IntegerAttr(0),
-          DenseI32ArrayAttr::get(ctx, ArrayRef<int32_t>(op.cmd.Value)));
     } else {
       llvm::errs() << "Unhandled txn opcode: " << op.cmd.Opcode << "\n";
       return failure();
     }
+    return success();
   }
-  return success();
+
+  OpBuilder &builder;
+  // Inserts globals into the device, ahead of the runtime sequence.
+  OpBuilder globalBuilder;
+  SymbolTable symbolTable;
+  const AIE::AIETargetModel &tm;
+  OutputType outputType;
+  Location loc;
+  llvm::DenseMap<Attribute, memref::GlobalOp> globals;
+  // Values of consecutive writes starting at 'pendingAddr' not yet emitted.
+  SmallVector<uint32_t> pendingWrites;
+  uint64_t pendingAddr = 0;
+};
+
+} // namespace
+
+// Payload of a blockwrite operation, as 32-bit words.
+static ArrayRef<uint32_t> getBlockData(const TransactionBinaryOperation &op) {
+  const uint32_t *d = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
+  return ArrayRef<uint32_t>(d, op.cmd.Size / 4);
 }
 
+namespace {
+
+// Register contents implied by applying a transaction to a device fresh out
+// of reset: for each register written, its value and which bits are known.
+struct RegisterImage {
+  struct Word {
+    uint32_t value = 0;
+    uint32_t known = 0;
+  };
+  llvm::DenseMap<uint64_t, Word> words;
+
+  void apply(const TransactionBinaryOperation &op) {
+    const XAie_TxnCmd &cmd = op.cmd;
+    if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE) {
+      words[cmd.RegOff] = {cmd.Value, ~0u};
+    } else if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
+      Word &w = words[cmd.RegOff];
+      w.value = (w.value & ~cmd.Mask) | (cmd.Value & cmd.Mask);
+      w.known |= cmd.Mask;
+    } else if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
+      ArrayRef<uint32_t> d = getBlockData(op);
+      for (size_t i = 0; i < d.size(); i++)
+        words[cmd.RegOff + i * 4] = {d[i], ~0u};
+    }
+  }
+
+  // True if the bits of 'mask' in the register at 'addr' are known to hold
+  // those of 'value'.
+  bool holds(uint64_t addr, uint32_t value, uint32_t mask) const {
+    auto it = words.find(addr);
+    if (it == words.end())
+      return false;
+    const Word &w = it->second;
+    return (w.known & mask) == mask && ((w.value ^ value) & mask) == 0;
+  }
+};
+
+// Filters the operations of a target configuration down to those that change
+// the state left by a baseline configuration, and forwards them to 'emit'.
+class TransactionDelta {
+public:
+  TransactionDelta(const AIETargetModel &tm, RegisterImage baseline,
+                   TransactionOpCallback emit)
+      : tm(tm), state(std::move(baseline)), emit(emit) {}
+
+  // Clear the config registers the baseline set and the target never writes,
+  // so that nothing from the baseline design stays routed. Must be called
+  // before the target's operations.
+  LogicalResult clearStale(const RegisterImage &target) {
+    SmallVector<uint64_t> stale;
+    for (auto &[addr, word] : state.words)
+      if (word.value != 0 && !target.words.count(addr) &&
+          getRegisterKind(tm, addr) == RegisterKind::Config)
+        stale.push_back(addr);
+    llvm::sort(stale);
+    for (uint64_t addr : stale)
+      if (failed(write(addr, 0)))
+        return failure();
+    return success();
+  }
+
+  LogicalResult apply(const TransactionBinaryOperation &op) {
+    const XAie_TxnCmd &cmd = op.cmd;
+    if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE) {
+      if (isCurrent(cmd.RegOff, cmd.Value, ~0u)) {
+        numDropped++;
+        return success();
+      }
+      return write(cmd.RegOff, cmd.Value);
+    }
+    if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) {
+      if (isCurrent(cmd.RegOff, cmd.Value, cmd.Mask)) {
+        numDropped++;
+        return success();
+      }
+      state.apply(op);
+      return emit(op);
+    }
+    if (cmd.Opcode != XAie_TxnOpcode::XAIE_IO_BLOCKWRITE)
+      return emit(op);
+
+    // Emit the runs of words that differ, pointing into the original payload.
+    ArrayRef<uint32_t> d = getBlockData(op);
+    size_t i = 0;
+    while (i < d.size()) {
+      if (isCurrent(cmd.RegOff + i * 4, d[i], ~0u)) {
+        numDropped++;
+        i++;
+        continue;
+      }
+      size_t end = i + 1;
+      while (end < d.size() && !isCurrent(cmd.RegOff + end * 4, d[end], ~0u))
+        end++;
+      TransactionBinaryOperation run(XAie_TxnOpcode::XAIE_IO_BLOCKWRITE, 0,
+                                     cmd.RegOff + i * 4, 0,
+                                     reinterpret_cast<const uint8_t *>(&d[i]),
+                                     (end - i) * 4);
+      state.apply(run);
+      if (failed(end - i == 1 ? write(run.cmd.RegOff, d[i]) : emit(run)))
+        return failure();
+      i = end;
+    }
+    return success();
+  }
+
+  // Number of words not written because they already held their value.
+  int numDropped = 0;
+
+private:
+  // True if writing 'value' under 'mask' to 'addr' would change nothing.
+  bool isCurrent(uint64_t addr, uint32_t value, uint32_t mask) const {
+    return getRegisterKind(tm, addr) != RegisterKind::Volatile &&
+           state.holds(addr, value, mask);
+  }
+
+  LogicalResult write(uint64_t addr, uint32_t value) {
+    TransactionBinaryOperation op(XAie_TxnOpcode::XAIE_IO_WRITE, 0, addr, value,
+                                  nullptr, 0);
+    state.apply(op);
+    return emit(op);
+  }
+
+  const AIETargetModel &tm;
+  // Register contents as left by the operations forwarded so far.
+  RegisterImage state;
+  TransactionOpCallback emit;
+};
+
+} // namespace
+
 // Perform bitwise or on consecutive control packets operating on the same
 // address, to resolve the lack of mask write in control packets.
 LogicalResult orConsecutiveWritesOnSameAddr(Block *body) {
@@ -339,42 +545,17 @@ LogicalResult orConsecutiveWritesOnSameAddr(Block *body) {
   return success();
 }
 
-// an enum to represent the output type of the transaction binary
-enum OutputType {
-  Transaction,
-  ControlPacket,
-};
-
-static LogicalResult convertTransactionOpsToMLIR(
-    OpBuilder builder, AIE::DeviceOp device, OutputType outputType,
-    std::vector<TransactionBinaryOperation> &operations) {
+// Decode the transaction binary 'data' and emit its operations into a new
+// runtime sequence at the builder's insertion point in 'device'. If a
+// 'baseline' transaction binary is given, only the operations needed to go
+// from the configuration it describes to the one in 'data' are emitted.
+static LogicalResult
+convertTransactionBinaryToOps(OpBuilder &builder, AIE::DeviceOp device,
+                              OutputType outputType, ArrayRef<uint8_t> data,
+                              ArrayRef<uint8_t> baseline = {}) {
 
   auto loc = builder.getUnknownLoc();
 
-  // for each blockwrite in the binary, create a GlobalOp with the data
-  std::vector<memref::GlobalOp> global_data;
-  for (auto &op : operations) {
-    if (op.cmd.Opcode != XAIE_IO_BLOCKWRITE) {
-      global_data.push_back(nullptr);
-      continue;
-    }
-    uint32_t size = op.cmd.Size / 4;
-    const uint32_t *d = reinterpret_cast<const uint32_t *>(op.cmd.DataPtr);
-    std::vector<uint32_t> data32(d, d + size);
-
-    int id = 0;
-    std::string name = "blockwrite_data";
-    while (device.lookupSymbol(name))
-      name = "blockwrite_data_" + std::to_string(id++);
-
-    MemRefType memrefType = MemRefType::get({size}, builder.getI32Type());
-    TensorType tensorType = RankedTensorType::get({size}, builder.getI32Type());
-    auto global = builder.create<memref::GlobalOp>(
-        loc, name, builder.getStringAttr("private"), memrefType,
-        DenseElementsAttr::get<uint32_t>(tensorType, data32), true, nullptr);
-    global_data.push_back(global);
-  }
-
   // create aiex.runtime_sequence
   int id = 0;
   std::string seq_name = "configure";
@@ -384,20 +565,49 @@ static LogicalResult convertTransactionOpsToMLIR(
   auto seq = builder.create<AIEX::RuntimeSequenceOp>(loc, seq_sym_name);
   seq.getBody().push_back(new Block);
 
-  // create the txn ops
+  // create the txn ops as the binary is decoded
+  OpBuilder::InsertionGuard guard(builder);
   builder.setInsertionPointToStart(&seq.getBody().front());
-  if (outputType == OutputType::Transaction) {
-    if (failed(emitTransactionOps(builder, operations, global_data)))
-      return failure();
-  } else if (outputType == OutputType::ControlPacket) {
-    if (failed(emitControlPacketOps(builder, operations, global_data)))
-      return failure();
-    // resolve mask writes; control packet doesn't natively support mask write.
-    if (failed(orConsecutiveWritesOnSameAddr(&seq.getBody().front())))
-      return failure();
+  TransactionOpEmitter emitter(builder, device, seq, outputType);
+  auto emit = [&](const TransactionBinaryOperation &op) {
+    return emitter.emit(op);
+  };
+  LogicalResult parsed = success();
+  if (baseline.empty()) {
+    parsed = parseTransactionBinary(data, emit);
   } else {
-    llvm_unreachable("bad output type");
+    RegisterImage baselineImage, targetImage;
+    auto record = [](RegisterImage &image) {
+      return [&image](const TransactionBinaryOperation &op) {
+        image.apply(op);
+        return success();
+      };
+    };
+    parsed = success(
+        succeeded(parseTransactionBinary(baseline, record(baselineImage))) &&
+        succeeded(parseTransactionBinary(data, record(targetImage))));
+    if (succeeded(parsed)) {
+      TransactionDelta delta(device.getTargetModel(), std::move(baselineImage),
+                             emit);
+      parsed = success(succeeded(delta.clearStale(targetImage)) &&
+                       succeeded(parseTransactionBinary(
+                           data, [&](const TransactionBinaryOperation &op) {
+                             return delta.apply(op);
+                           })));
+      LLVM_DEBUG(llvm::dbgs() << "Dropped " << delta.numDropped
+                              << " writes already done by the baseline\n");
+    }
   }
+  if (failed(parsed)) {
+    llvm::errs() << "Failed to parse binary\n";
+    return failure();
+  }
+  emitter.finish();
+
+  // resolve mask writes; control packet doesn't natively support mask write.
+  if (outputType == OutputType::ControlPacket &&
+      failed(orConsecutiveWritesOnSameAddr(&seq.getBody().front())))
+    return failure();
 
   return success();
 }
@@ -408,16 +618,19 @@ static LogicalResult convertTransactionOpsToMLIR(
 // npu.blockwrite operations. On failure return std::nullopt.
 std::optional<mlir::ModuleOp>
 xilinx::AIE::convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
-                                            std::vector<uint8_t> &binary) {
+                                            ArrayRef<uint8_t> binary) {
 
-  // parse the binary
-  std::vector<TransactionBinaryOperation> operations;
-  auto c = parseTransactionBinary(binary, operations);
-  if (!c) {
+  // parse the header to find the device size
+  auto hdr = parseTransactionHeader(binary);
+  if (!hdr) {
     llvm::errs() << "Failed to parse binary\n";
     return std::nullopt;
   }
-  int columns = *c;
+  int columns = hdr->numCols;
+  if (columns < 1 || columns > 5) {
+    llvm::errs() << "Unsupported number of columns: " << columns << "\n";
+    return std::nullopt;
+  }
 
   auto loc = mlir::UnknownLoc::get(ctx);
 
@@ -435,63 +648,245 @@ xilinx::AIE::convertTransactionBinaryToMLIR(mlir::MLIRContext *ctx,
   DeviceOp::ensureTerminator(device.getBodyRegion(), builder, loc);
   builder.setInsertionPointToStart(device.getBody());
 
-  // convert the parsed ops to MLIR
-  if (failed(convertTransactionOpsToMLIR(builder, device,
-                                         OutputType::Transaction, operations)))
+  // convert the binary to MLIR
+  if (failed(convertTransactionBinaryToOps(builder, device,
+                                           OutputType::Transaction, binary))) {
+    module.erase();
     return std::nullopt;
+  }
 
   return module;
 }
 
-static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
-                                               StringRef clElfDir,
-                                               OutputType outputType) {
-
+// Generate the configuration of 'device' with libxaie and export it as a
+// serialized transaction binary. The caller owns the returned buffer and must
+// free() it. Returns nullptr on failure.
+static uint8_t *generateTransactionBinary(AIE::DeviceOp device,
+                                          StringRef elfDir,
+                                          bool optimizeWrites) {
   const BaseNPUTargetModel &targetModel =
       (const BaseNPUTargetModel &)device.getTargetModel();
 
   if (!targetModel.hasProperty(AIETargetModel::IsNPU))
-    return failure();
+    return nullptr;
 
   bool aieSim = false;
   bool xaieDebug = false;
 
   AIERTControl ctl(targetModel);
   if (failed(ctl.setIOBackend(aieSim, xaieDebug)))
-    return failure();
+    return nullptr;
 
   // start collecting transations
-  XAie_StartTransaction(&ctl.devInst, XAIE_TRANSACTION_DISABLE_AUTO_FLUSH);
+  ctl.startTransaction();
 
-  bool generateElfs = clElfDir.size() > 0;
-  if (failed(generateTransactions(ctl, clElfDir, device, aieSim, generateElfs,
+  bool generateElfs = elfDir.size() > 0;
+  if (failed(generateTransactions(ctl, elfDir, device, aieSim, generateElfs,
                                   true, true)))
-    return failure();
+    return nullptr;
 
-  // Export the transactions to a binary buffer
-  uint8_t *txn_ptr = XAie_ExportSerializedTransaction(&ctl.devInst, 0, 0);
-  XAie_TxnHeader *hdr = (XAie_TxnHeader *)txn_ptr;
-  std::vector<uint8_t> txn_data(txn_ptr, txn_ptr + hdr->TxnSize);
+  // Drop redundant writes, then export the transactions to a binary buffer
+  if (optimizeWrites && failed(ctl.optimizeTransaction()))
+    return nullptr;
+  return XAie_ExportSerializedTransaction(&ctl.devInst, 0, 0);
+}
 
-  // parse the binary data
-  std::vector<TransactionBinaryOperation> operations;
-  if (!parseTransactionBinary(txn_data, operations)) {
-    llvm::errs() << "Failed to parse binary\n";
+static ArrayRef<uint8_t> getTransactionData(const uint8_t *txn_ptr) {
+  const XAie_TxnHeader *hdr = (const XAie_TxnHeader *)txn_ptr;
+  return ArrayRef<uint8_t>(txn_ptr, hdr->TxnSize);
+}
+
+// Load the design in 'baselinePath' and generate its transaction binary.
+// The design is parsed in a context of its own, so that doing so cannot load
+// dialects into the context of the running pass.
+static uint8_t *generateBaselineTransactionBinary(AIE::DeviceOp device,
+                                                  StringRef baselinePath,
+                                                  StringRef elfDir,
+                                                  bool optimizeWrites) {
+  MLIRContext ctx(device->getContext()->getDialectRegistry());
+  OwningOpRef<ModuleOp> module =
+      parseSourceFile<ModuleOp>(baselinePath, ParserConfig(&ctx));
+  if (!module) {
+    device.emitError("failed to parse baseline design ") << baselinePath;
+    return nullptr;
+  }
+  auto devOps = module->getOps<AIE::DeviceOp>();
+  if (llvm::range_size(devOps) != 1) {
+    device.emitError("baseline design must contain exactly one aie.device");
+    return nullptr;
+  }
+  AIE::DeviceOp baseline = *devOps.begin();
+  if (baseline.getDevice() != device.getDevice()) {
+    device.emitError("baseline design targets a different device");
+    return nullptr;
+  }
+  return generateTransactionBinary(baseline, elfDir, optimizeWrites);
+}
+
+static LogicalResult convertAIEToConfiguration(AIE::DeviceOp device,
+                                               StringRef clElfDir,
+                                               OutputType outputType,
+                                               StringRef clBaseline = "",
+                                               StringRef clBaselineElfDir = "",
+                                               bool optimizeWrites = false) {
+  uint8_t *txn_ptr =
+      generateTransactionBinary(device, clElfDir, optimizeWrites);
+  if (!txn_ptr)
     return failure();
+
+  uint8_t *baseline_ptr = nullptr;
+  if (!clBaseline.empty()) {
+    baseline_ptr =
+        generateBaselineTransactionBinary(device, clBaseline, clBaselineElfDir,
+                                          optimizeWrites);
+    if (!baseline_ptr) {
+      free(txn_ptr);
+      return failure();
+    }
   }
 
   OpBuilder builder(device.getBodyRegion());
 
-  // convert the parsed ops to MLIR
-  if (failed(
-          convertTransactionOpsToMLIR(builder, device, outputType, operations)))
-    return failure();
-
-  return success();
+  // convert the binary to MLIR, decoding it in place
+  auto result = convertTransactionBinaryToOps(
+      builder, device, outputType, getTransactionData(txn_ptr),
+      baseline_ptr ? getTransactionData(baseline_ptr) : ArrayRef<uint8_t>());
+  free(txn_ptr);
+  free(baseline_ptr);
+  return result;
 }
 
 namespace {
 
+// Packs the control packets of a runtime sequence into as few packets as
+// possible. Packets are only combined when they write consecutive words of
+// one tile, at most kMaxPayload words at a time. Writes to configuration and
+// program memory registers have no effect until a side-effecting write, so
+// between two side-effecting packets they are collected, with later writes
+// replacing earlier ones, and reissued sorted by address: each tile's words
+// then go out back to back and runs of consecutive words share a packet.
+// Other packets keep their relative order.
+class ControlPacketPacker {
+public:
+  // The control packet header encodes the payload size in two bits.
+  static constexpr unsigned kMaxPayload = 4;
+
+  ControlPacketPacker(const AIETargetModel &tm) : tm(tm) {}
+
+  void run(Block &block) {
+    for (Operation &o : llvm::make_early_inc_range(block)) {
+      auto op = dyn_cast<AIEX::NpuControlPacketOp>(&o);
+      if (!op) {
+        flush(&o);
+        last = nullptr;
+        continue;
+      }
+      numBefore++;
+      std::optional<ArrayRef<int32_t>> data = op.getData();
+      bool isPackable =
+          op.getOpcode() == 0 && op.getStreamId() == 0 && data &&
+          !data->empty() &&
+          (!op.getLength() || *op.getLength() == (int)data->size());
+      if (!isPackable) {
+        flush(op);
+        numAfter++;
+        last = nullptr;
+        continue;
+      }
+
+      uint32_t addr = op.getAddress();
+      bool isConfig = llvm::all_of(llvm::seq<size_t>(0, data->size()),
+                                   [&](size_t i) {
+                                     return getRegisterKind(tm, addr + i * 4) !=
+                                            RegisterKind::Volatile;
+                                   });
+      if (isConfig) {
+        for (auto [i, value] : llvm::enumerate(*data))
+          pendingWords[addr + i * 4] = value;
+        op.erase();
+        continue;
+      }
+
+      // A side-effecting write: issue the collected writes before it, then
+      // append it to the previous packet if that writes the word before.
+      flush(op);
+      if (last && canAppend(last, addr, data->size())) {
+        appendTo(last, *data);
+        op.erase();
+        continue;
+      }
+      numAfter++;
+      last = op;
+    }
+    flush(nullptr, &block);
+  }
+
+  int numBefore = 0;
+  int numAfter = 0;
+
+private:
+  bool sameTile(uint32_t a, uint32_t b) {
+    return (a >> tm.getRowShift()) == (b >> tm.getRowShift());
+  }
+
+  bool canAppend(AIEX::NpuControlPacketOp prev, uint32_t addr, size_t size) {
+    ArrayRef<int32_t> prevData = *prev.getData();
+    return prev.getAddress() + prevData.size() * 4 == addr &&
+           prevData.size() + size <= kMaxPayload &&
+           sameTile(prev.getAddress(), addr);
+  }
+
+  void appendTo(AIEX::NpuControlPacketOp prev, ArrayRef<int32_t> data) {
+    SmallVector<int32_t> merged(*prev.getData());
+    merged.append(data.begin(), data.end());
+    prev.setDataAttr(DenseI32ArrayAttr::get(prev->getContext(), merged));
+  }
+
+  // Issue the collected configuration writes in address order, in front of
+  // 'before', or at the end of 'block' if 'before' is null.
+  void flush(Operation *before, Block *block = nullptr) {
+    if (pendingWords.empty())
+      return;
+    OpBuilder builder =
+        before ? OpBuilder(before) : OpBuilder::atBlockEnd(block);
+    Location loc = builder.getUnknownLoc();
+    SmallVector<int32_t> payload;
+    uint32_t start = 0;
+    auto emit = [&] {
+      builder.create<AIEX::NpuControlPacketOp>(
+          loc, builder.getUI32IntegerAttr(start), nullptr,
+          /*opcode*/ builder.getI32IntegerAttr(0),
+          /*stream_id*/ builder.getI32IntegerAttr(0),
+          DenseI32ArrayAttr::get(builder.getContext(), payload));
+      numAfter++;
+      payload.clear();
+    };
+    for (auto [addr, value] : pendingWords) {
+      if (!payload.empty() &&
+          (addr != start + payload.size() * 4 ||
+           payload.size() == kMaxPayload || !sameTile(addr, start)))
+        emit();
+      if (payload.empty())
+        start = addr;
+      payload.push_back(value);
+    }
+    emit();
+    pendingWords.clear();
+    // Nothing may be appended across the reissued writes.
+    last = nullptr;
+  }
+
+  const AIETargetModel &tm;
+  // Collected configuration writes, by address.
+  std::map<uint32_t, int32_t> pendingWords;
+  // The last packet issued, while it may still be extended.
+  AIEX::NpuControlPacketOp last;
+};
+
+} // namespace
+
+namespace {
+
 struct ConvertAIEToTransactionPass
     : ConvertAIEToTransactionBase<ConvertAIEToTransactionPass> {
   void getDependentDialects(DialectRegistry &registry) const override {
@@ -499,7 +894,8 @@ struct ConvertAIEToTransactionPass
   }
   void runOnOperation() override {
     if (failed(convertAIEToConfiguration(getOperation(), clElfDir,
-                                         OutputType::Transaction)))
+                                         OutputType::Transaction, clBaseline,
+                                         clBaselineElfDir, clOptimizeWrites)))
       return signalPassFailure();
   }
 };
@@ -511,13 +907,38 @@ struct ConvertAIEToControlPacketsPass
   }
   void runOnOperation() override {
     if (failed(convertAIEToConfiguration(getOperation(), clElfDir,
-                                         OutputType::ControlPacket)))
+                                         OutputType::ControlPacket, clBaseline,
+                                         clBaselineElfDir, clOptimizeWrites)))
       return signalPassFailure();
   }
 };
 
+struct AIEPackControlPacketsPass
+    : public AIEPackControlPacketsBase<AIEPackControlPacketsPass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    for (auto seq : device.getOps<AIEX::RuntimeSequenceOp>()) {
+      if (seq.getBody().empty())
+        continue;
+      ControlPacketPacker packer(device.getTargetModel());
+      packer.run(seq.getBody().front());
+      LLVM_DEBUG(llvm::dbgs()
+                 << "runtime sequence " << seq.getSymName().value_or("")
+                 << ": packed " << packer.numBefore << " control packets into "
+                 << packer.numAfter << "\n");
+      numPacketsBefore += packer.numBefore;
+      numPacketsAfter += packer.numAfter;
+    }
+  }
+};
+
 } // end anonymous namespace
 
+std::unique_ptr<mlir::OperationPass<xilinx::AIE::DeviceOp>>
+xilinx::AIE::createAIEPackControlPacketsPass() {
+  return std::make_unique<AIEPackControlPacketsPass>();
+}
+
 std::unique_ptr<mlir::OperationPass<xilinx::AIE::DeviceOp>>
 xilinx::AIE::createConvertAIEToTransactionPass() {
   return std::make_unique<ConvertAIEToTransactionPass>();
@@ -1772,6 +1772,275 @@ public:
   }
 };
 
+template <typename MinGeIntrOpT, typename MaxLtIntrOpT>
+static Value createMinGeOrMaxLtIntrOp(OpBuilder &builder, Location loc,
+                                      Type resTy, ValueRange operands,
+                                      bool ge) {
+  if (ge)
+    return builder.create<MinGeIntrOpT>(loc, resTy, operands);
+  return builder.create<MaxLtIntrOpT>(loc, resTy, operands);
+}
+
+// Emits a vmin.ge (ge = true) or vmax.lt (ge = false) intrinsic on two
+// 512-bit vectors and returns its lane mask, i.e. the lanes where lhs >= rhs
+// or lhs < rhs. The mask is an i32, or an i64 for 64 lanes. The min/max
+// result of the intrinsic is left unused.
+static Value createCmpMask(OpBuilder &builder, Location loc, Value lhs,
+                           Value rhs, bool ge, bool isSigned) {
+  auto vecTy = cast<VectorType>(lhs.getType());
+  Type scaTy = vecTy.getElementType();
+  unsigned bitWidth = scaTy.getIntOrFloatBitWidth();
+  Type i32Ty = builder.getI32Type();
+  MLIRContext *ctx = builder.getContext();
+
+  Value cmpOp;
+  if (isa<FloatType>(scaTy)) {
+    auto v32bf16Ty = VectorType::get({32}, builder.getBF16Type());
+    auto resTy = LLVM::LLVMStructType::getLiteral(ctx, {v32bf16Ty, i32Ty});
+    auto operands = forceCastOperandsToSignature(builder, loc, {lhs, rhs},
+                                                 {v32bf16Ty, v32bf16Ty});
+    cmpOp = createMinGeOrMaxLtIntrOp<xllvm::VectorMinGeBf16IntrOp,
+                                     xllvm::VectorMaxLtBf16IntrOp>(
+        builder, loc, resTy, operands, ge);
+  } else {
+    auto signCst = builder.create<LLVM::ConstantOp>(
+        loc, i32Ty, builder.getI32IntegerAttr(isSigned));
+    auto laneTy =
+        VectorType::get({512 / bitWidth}, builder.getIntegerType(bitWidth));
+    Type maskTy = bitWidth == 8 ? VectorType::get({2}, i32Ty) : i32Ty;
+    auto resTy = LLVM::LLVMStructType::getLiteral(ctx, {laneTy, maskTy});
+    auto operands = forceCastOperandsToSignature(
+        builder, loc, {lhs, rhs, signCst}, {laneTy, laneTy, i32Ty});
+    if (bitWidth == 8)
+      cmpOp = createMinGeOrMaxLtIntrOp<xllvm::VectorMinGe8IntrOp,
+                                       xllvm::VectorMaxLt8IntrOp>(
+          builder, loc, resTy, operands, ge);
+    else if (bitWidth == 16)
+      cmpOp = createMinGeOrMaxLtIntrOp<xllvm::VectorMinGe16IntrOp,
+                                       xllvm::VectorMaxLt16IntrOp>(
+          builder, loc, resTy, operands, ge);
+    else
+      cmpOp = createMinGeOrMaxLtIntrOp<xllvm::VectorMinGe32IntrOp,
+                                       xllvm::VectorMaxLt32IntrOp>(
+          builder, loc, resTy, operands, ge);
+  }
+
+  Value mask = builder.create<LLVM::ExtractValueOp>(loc, cmpOp,
+                                                    /*position=*/1);
+  if (bitWidth == 8)
+    mask = bitcastValueToType(builder, loc, mask, builder.getI64Type());
+  return mask;
+}
+
+// Returns true if `type` is a 512-bit vector of i8, i16, i32 or bf16 lanes,
+// which is what the AIE2 compare and select instructions operate on.
+static bool isCmpSelVectorType(VectorType type) {
+  Type scaTy = type.getElementType();
+  unsigned bitWidth = scaTy.getIntOrFloatBitWidth();
+  if (bitWidth * getVectorLaneSize(type) != 512)
+    return false;
+  if (isa<FloatType>(scaTy))
+    return scaTy.isBF16();
+  return bitWidth == 8 || bitWidth == 16 || bitWidth == 32;
+}
+
+class CmpOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::CmpOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::CmpOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::CmpOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto lhsTy = cast<VectorType>(op.getLhs().getType());
+    if (!isCmpSelVectorType(lhsTy)) {
+      op.emitWarning() << "aievec.cmp conversion with " << lhsTy
+                       << " operands is not supported.\n";
+      return failure();
+    }
+
+    Value lhs = adaptor.getLhs();
+    Value rhs = adaptor.getRhs();
+    StringRef pred = op.getPred();
+    Value mask;
+    if (pred == "eq" || pred == "ne") {
+      // lhs == rhs iff lhs >= rhs and rhs >= lhs; lhs != rhs iff lhs < rhs
+      // or rhs < lhs.
+      bool eq = pred == "eq";
+      Value mask0 = createCmpMask(rewriter, loc, lhs, rhs, eq, true);
+      Value mask1 = createCmpMask(rewriter, loc, rhs, lhs, eq, true);
+      if (eq)
+        mask = rewriter.create<LLVM::AndOp>(loc, mask0.getType(), mask0, mask1);
+      else
+        mask = rewriter.create<LLVM::OrOp>(loc, mask0.getType(), mask0, mask1);
+    } else if (bool isSigned = pred.consume_front("s");
+               isSigned || pred.consume_front("u")) {
+      // Only lt and ge exist in hardware; gt and le swap the operands.
+      if (pred == "lt" || pred == "ge")
+        mask = createCmpMask(rewriter, loc, lhs, rhs, pred == "ge", isSigned);
+      else if (pred == "gt" || pred == "le")
+        mask = createCmpMask(rewriter, loc, rhs, lhs, pred == "le", isSigned);
+    }
+
+    if (!mask) {
+      op.emitWarning() << "aievec.cmp predicate '" << op.getPred()
+                       << "' is not supported.\n";
+      return failure();
+    }
+
+    rewriter.replaceOp(op, mask);
+    return success();
+  }
+};
+
+class SelOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::SelOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::SelOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::SelOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    if (!isCmpSelVectorType(resultType)) {
+      op.emitWarning() << "aievec.sel conversion with " << resultType
+                       << " result is not supported.\n";
+      return failure();
+    }
+
+    unsigned bitWidth = resultType.getElementTypeBitWidth();
+    Type i32Ty = rewriter.getI32Type();
+    // aievec.sel picks rhs for set mask bits while vsel picks its first
+    // operand, so the data operands are swapped.
+    SmallVector<Value> operands{adaptor.getRhs(), adaptor.getLhs(),
+                                adaptor.getSel()};
+    Value selOp;
+    if (bitWidth == 8) {
+      auto v64i8Ty = VectorType::get({64}, rewriter.getI8Type());
+      selOp = rewriter.create<xllvm::VectorSel8IntrOp>(
+          loc, v64i8Ty,
+          forceCastOperandsToSignature(
+              rewriter, loc, operands,
+              {v64i8Ty, v64i8Ty, VectorType::get({2}, i32Ty)}));
+    } else if (bitWidth == 16) {
+      auto v32i16Ty = VectorType::get({32}, rewriter.getI16Type());
+      selOp = rewriter.create<xllvm::VectorSel16IntrOp>(
+          loc, v32i16Ty,
+          forceCastOperandsToSignature(rewriter, loc, operands,
+                                       {v32i16Ty, v32i16Ty, i32Ty}));
+    } else {
+      auto v16i32Ty = VectorType::get({16}, i32Ty);
+      selOp = rewriter.create<xllvm::VectorSel32IntrOp>(
+          loc, v16i32Ty,
+          forceCastOperandsToSignature(rewriter, loc, operands,
+                                       {v16i32Ty, v16i32Ty, i32Ty}));
+    }
+
+    rewriter.replaceOp(op, forceCastValueToType(rewriter, loc, selOp,
+                                                resultType));
+    return success();
+  }
+};
+
+// The AIE2 bitwise ops work on the 512-bit register as a whole, so they are
+// lowered to the plain LLVM ops on a vector<16xi32> view of the operands.
+template <typename SrcOpT, typename DstOpT>
+class BitwiseOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpT> {
+public:
+  using mlir::ConvertOpToLLVMPattern<SrcOpT>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpT::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpT op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    if (getVectorSizeInBits(resultType) != 512) {
+      op.emitWarning() << op->getName() << " conversion with " << resultType
+                       << " result is not supported.\n";
+      return failure();
+    }
+
+    auto v16i32Ty = VectorType::get({16}, rewriter.getI32Type());
+    auto operands = forceCastOperandsToSignature(
+        rewriter, loc, {adaptor.getLhs(), adaptor.getRhs()},
+        {v16i32Ty, v16i32Ty});
+    auto resOp =
+        rewriter.create<DstOpT>(loc, v16i32Ty, operands[0], operands[1]);
+    rewriter.replaceOp(op, forceCastValueToType(rewriter, loc, resOp,
+                                                op.getResult().getType()));
+    return success();
+  }
+};
+
+using BxorOpConversion = BitwiseOpConversion<aievec::BxorOp, LLVM::XOrOp>;
+using BorOpConversion = BitwiseOpConversion<aievec::BorOp, LLVM::OrOp>;
+using BandOpConversion = BitwiseOpConversion<aievec::BandOp, LLVM::AndOp>;
+
+class BnegOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::BnegOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::BnegOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::BnegOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    if (getVectorSizeInBits(resultType) != 512) {
+      op.emitWarning() << "aievec.bneg conversion with " << resultType
+                       << " result is not supported.\n";
+      return failure();
+    }
+
+    auto v16i32Ty = VectorType::get({16}, rewriter.getI32Type());
+    auto allOnes = rewriter.create<LLVM::ConstantOp>(
+        loc, v16i32Ty,
+        DenseElementsAttr::get(v16i32Ty, static_cast<int32_t>(-1)));
+    auto resOp = rewriter.create<LLVM::XOrOp>(
+        loc, v16i32Ty,
+        forceCastValueToType(rewriter, loc, adaptor.getSource(), v16i32Ty),
+        allOnes);
+    rewriter.replaceOp(op, forceCastValueToType(rewriter, loc, resOp,
+                                                op.getResult().getType()));
+    return success();
+  }
+};
+
+// aievec.neg negates an accumulator. Integer lanes are subtracted from zero
+// and float lanes get their sign bit flipped.
+class NegOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::NegOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::NegOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::NegOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto srcTy = cast<VectorType>(adaptor.getSource().getType());
+    unsigned bitWidth = srcTy.getElementTypeBitWidth();
+    auto intTy =
+        VectorType::get(srcTy.getShape(), rewriter.getIntegerType(bitWidth));
+    Value src = adaptor.getSource();
+
+    Value resVal;
+    if (isa<FloatType>(srcTy.getElementType())) {
+      auto signMask = rewriter.create<LLVM::ConstantOp>(
+          loc, intTy,
+          DenseElementsAttr::get(intTy, APInt::getSignMask(bitWidth)));
+      resVal = rewriter.create<LLVM::XOrOp>(
+          loc, intTy, bitcastValueToType(rewriter, loc, src, intTy), signMask);
+      resVal = bitcastValueToType(rewriter, loc, resVal, srcTy);
+    } else {
+      auto zero = rewriter.create<LLVM::ConstantOp>(
+          loc, intTy, rewriter.getZeroAttr(intTy));
+      resVal = rewriter.create<LLVM::SubOp>(loc, intTy, zero, src);
+    }
+
+    rewriter.replaceOp(op, resVal);
+    return success();
+  }
+};
+
 class BroadcastScalarOpConversion
     : public mlir::ConvertOpToLLVMPattern<aievec::BroadcastScalarOp> {
 public:
@@ -2342,6 +2611,13 @@ void populateAIEVecToLLVMConversionPatterns(
                MatMulOpConversion,
                MaxOpConversion,
                MinOpConversion,
+               CmpOpConversion,
+               SelOpConversion,
+               BxorOpConversion,
+               BnegOpConversion,
+               BorOpConversion,
+               BandOpConversion,
+               NegOpConversion,
                ShiftOpConversion,
                ExtractElemOpConversion,
                FoldAIECastOps,
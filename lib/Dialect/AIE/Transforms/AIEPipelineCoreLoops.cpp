@@ -0,0 +1,220 @@
+//===- AIEPipelineCoreLoops.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/SCF/Transforms/Transforms.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "aie-pipeline-core-loops"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Returns the memref read by 'op' if it is a plain load, or null.
+static Value getLoadedMemref(Operation *op) {
+  Value memref = llvm::TypeSwitch<Operation *, Value>(op)
+                     .Case<vector::TransferReadOp>(
+                         [](auto readOp) { return readOp.getSource(); })
+                     .Case<vector::LoadOp>(
+                         [](auto loadOp) { return loadOp.getBase(); })
+                     .Case<memref::LoadOp>(
+                         [](auto loadOp) { return loadOp.getMemRef(); })
+                     .Default([](Operation *) { return Value(); });
+  return memref && isa<MemRefType>(memref.getType()) ? memref : Value();
+}
+
+// Returns the memref written by 'op' if it is a plain store, or null.
+static Value getStoredMemref(Operation *op) {
+  Value memref = llvm::TypeSwitch<Operation *, Value>(op)
+                     .Case<vector::TransferWriteOp>(
+                         [](auto writeOp) { return writeOp.getSource(); })
+                     .Case<vector::StoreOp>(
+                         [](auto storeOp) { return storeOp.getBase(); })
+                     .Case<memref::StoreOp>(
+                         [](auto storeOp) { return storeOp.getMemRef(); })
+                     .Default([](Operation *) { return Value(); });
+  return memref && isa<MemRefType>(memref.getType()) ? memref : Value();
+}
+
+static Value getRootMemref(Value memref) {
+  while (auto view = memref.getDefiningOp<ViewLikeOpInterface>())
+    memref = view.getViewSource();
+  return memref;
+}
+
+// Returns false only if 'a' and 'b' are known to point into different
+// allocations.
+static bool mayAlias(Value a, Value b) {
+  a = getRootMemref(a);
+  b = getRootMemref(b);
+  if (a == b)
+    return true;
+  auto globalA = a.getDefiningOp<memref::GetGlobalOp>();
+  auto globalB = b.getDefiningOp<memref::GetGlobalOp>();
+  if (globalA && globalB)
+    return globalA.getName() == globalB.getName();
+  auto isAllocation = [](Value v) {
+    return isa_and_present<BufferOp, memref::AllocOp, memref::AllocaOp,
+                           memref::GetGlobalOp>(v.getDefiningOp());
+  };
+  return !isAllocation(a) || !isAllocation(b);
+}
+
+// Collect the ops of the loop body that compute the operands of 'op'. Fails if
+// any of them has side effects or depends on a loop-carried value, in which
+// case 'op' cannot be issued one iteration early.
+static bool collectOperandSlice(Operation *op, scf::ForOp forOp,
+                                llvm::SetVector<Operation *> &slice) {
+  Block *body = forOp.getBody();
+  SmallVector<Operation *> worklist{op};
+  while (!worklist.empty()) {
+    Operation *current = worklist.pop_back_val();
+    for (Value operand : current->getOperands()) {
+      if (auto arg = dyn_cast<BlockArgument>(operand)) {
+        if (arg.getOwner() == body && arg != forOp.getInductionVar())
+          return false;
+        continue;
+      }
+      Operation *def = operand.getDefiningOp();
+      if (def->getBlock() != body || slice.contains(def))
+        continue;
+      if (def->getNumRegions() || !isPure(def))
+        return false;
+      slice.insert(def);
+      worklist.push_back(def);
+    }
+  }
+  return true;
+}
+
+// Compute a two-stage schedule for 'forOp': loads that do not depend on the
+// previous iteration, together with their address computation, go in stage 0
+// and everything else in stage 1. After pipelining, the loads of iteration
+// i+1 are issued ahead of the computation of iteration i, and the loaded
+// values are carried to the next iteration in loop-carried registers.
+// Returns false if the loop should be left alone.
+static bool
+getTwoStageSchedule(scf::ForOp forOp,
+                    std::vector<std::pair<Operation *, unsigned>> &schedule) {
+  Block *body = forOp.getBody();
+  SmallVector<Operation *> loads;
+  SmallVector<Value> storedMemrefs;
+  for (Operation &op : body->without_terminator()) {
+    if (getLoadedMemref(&op)) {
+      loads.push_back(&op);
+      continue;
+    }
+    if (Value memref = getStoredMemref(&op)) {
+      storedMemrefs.push_back(memref);
+      continue;
+    }
+    // Nested regions, locks, calls and other side effects are not reordered.
+    if (op.getNumRegions() || !isPure(&op))
+      return false;
+  }
+  if (llvm::none_of(loads, [](Operation *op) {
+        return isa<VectorType>(op->getResult(0).getType());
+      }))
+    return false;
+
+  ValueRange yielded = body->getTerminator()->getOperands();
+  llvm::SetVector<Operation *> early;
+  for (Operation *load : loads) {
+    // A load that may observe a store of the previous iteration must stay
+    // after it.
+    Value memref = getLoadedMemref(load);
+    if (llvm::any_of(storedMemrefs,
+                     [&](Value stored) { return mayAlias(memref, stored); }))
+      continue;
+    if (llvm::is_contained(yielded, load->getResult(0)))
+      continue;
+    llvm::SetVector<Operation *> slice;
+    if (!collectOperandSlice(load, forOp, slice))
+      continue;
+    early.insert(slice.begin(), slice.end());
+    early.insert(load);
+  }
+  // Both stages must have work for the rotation to overlap anything.
+  if (early.empty() || early.size() == body->getOperations().size() - 1)
+    return false;
+
+  for (Operation &op : body->without_terminator())
+    if (early.contains(&op))
+      schedule.emplace_back(&op, 0);
+  for (Operation &op : body->without_terminator())
+    if (!early.contains(&op))
+      schedule.emplace_back(&op, 1);
+  return true;
+}
+
+static bool hasConstantTripCountOfAtLeast(scf::ForOp forOp, int64_t count) {
+  auto lb = getConstantIntValue(forOp.getLowerBound());
+  auto ub = getConstantIntValue(forOp.getUpperBound());
+  auto step = getConstantIntValue(forOp.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return false;
+  return *ub > *lb && llvm::divideCeil(*ub - *lb, *step) >= count;
+}
+
+struct AIEPipelineCoreLoopsPass
+    : AIEPipelineCoreLoopsBase<AIEPipelineCoreLoopsPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+
+    SmallVector<scf::ForOp> loops;
+    for (auto core : device.getOps<CoreOp>())
+      core.walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+    for (auto func : device.getOps<func::FuncOp>())
+      func.walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+
+    IRRewriter rewriter(&getContext());
+    int numPipelined = 0;
+    for (scf::ForOp forOp : loops) {
+      std::vector<std::pair<Operation *, unsigned>> schedule;
+      if (!hasConstantTripCountOfAtLeast(forOp, 2) ||
+          !getTwoStageSchedule(forOp, schedule))
+        continue;
+
+      scf::PipeliningOption options;
+      options.getScheduleFn =
+          [&](scf::ForOp, std::vector<std::pair<Operation *, unsigned>> &s) {
+            s = schedule;
+          };
+      bool modifiedIR = false;
+      if (failed(scf::pipelineForLoop(rewriter, forOp, options, &modifiedIR))) {
+        if (modifiedIR) {
+          forOp.emitOpError("failed to pipeline loop");
+          return signalPassFailure();
+        }
+        continue;
+      }
+      numPipelined++;
+    }
+    LLVM_DEBUG(llvm::dbgs() << "pipelined " << numPipelined << " of "
+                            << loops.size() << " loops\n");
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEPipelineCoreLoopsPass() {
+  return std::make_unique<AIEPipelineCoreLoopsPass>();
+}
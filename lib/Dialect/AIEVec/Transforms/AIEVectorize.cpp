@@ -25,6 +25,7 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Vector/Transforms/VectorTransforms.h"
+#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/Passes.h"
@@ -2462,6 +2463,187 @@ static void insertUPDOpsInFunc(func::FuncOp func, VectState *state) {
   }
 }
 
+// If 'index' is computed as 'iv + c' for the induction variable 'iv', return
+// c. Otherwise return std::nullopt.
+static std::optional<int64_t> getOffsetFromInductionVar(Value index,
+                                                        Value iv) {
+  if (index == iv)
+    return 0;
+  auto apOf = index.getDefiningOp<affine::AffineApplyOp>();
+  if (!apOf || apOf.getMapOperands().size() != 1 ||
+      apOf.getMapOperands()[0] != iv)
+    return std::nullopt;
+  AffineMap map = apOf.getAffineMap();
+  if (map.getNumDims() != 1)
+    return std::nullopt;
+  AffineExpr diff = simplifyAffineExpr(
+      map.getResult(0) - getAffineDimExpr(0, map.getContext()), 1, 0);
+  if (auto constExpr = dyn_cast<AffineConstantExpr>(diff))
+    return constExpr.getValue();
+  return std::nullopt;
+}
+
+// Materialize before 'forOp' the indices of 'updOp' as they are in the first
+// iteration of the loop. Returns false if an index cannot be computed outside
+// the loop.
+static bool getFirstIterationIndices(aievec::UPDOp updOp,
+                                     affine::AffineForOp forOp, Value lb,
+                                     SmallVector<Value, 4> &indices,
+                                     VectState *state) {
+  IRMapping mapping;
+  mapping.map(forOp.getInductionVar(), lb);
+  for (Value index : updOp.getIndices()) {
+    if (forOp.isDefinedOutsideOfLoop(index) ||
+        index == forOp.getInductionVar()) {
+      indices.push_back(mapping.lookupOrDefault(index));
+      continue;
+    }
+    auto apOf = index.getDefiningOp<affine::AffineApplyOp>();
+    if (!apOf || llvm::any_of(apOf.getMapOperands(), [&](Value operand) {
+          return !forOp.isDefinedOutsideOfLoop(operand) &&
+                 operand != forOp.getInductionVar();
+        }))
+      return false;
+    indices.push_back(state->builder.clone(*apOf, mapping)->getResult(0));
+  }
+  return true;
+}
+
+// Sliding-window kernels load the interval [j, j+2w) in iteration j of the
+// vectorized loop as two UPD ops of width w, idx=0 and idx=1. If the loop
+// advances by w, the idx=0 half of the next iteration is exactly the idx=1
+// half of this one. In that case, load the first idx=0 half before the loop,
+// and then carry the idx=1 half of each iteration to the next one in a loop
+// register, halving the loads for that interval. Consider the following
+// example with a 512-bit interval and an 8-lane i32 loop:
+//   for (j = 0; j < N; j += 8) {
+//     lo = upd(A[i][j], 0);
+//     v = upd(A[i][j], lo, 1);
+//     ...
+//   }
+// The loop is rewritten as:
+//   lo = upd(A[i][0], 0);
+//   for (j = 0; j < N; j += 8, lo = concat(ext(v, 1), ext(v, 1))) {
+//     v = upd(A[i][j], lo, 1);
+//     ...
+//   }
+static void carryUPDOpsAcrossIterations(affine::AffineForOp forOp,
+                                        VectState *state) {
+  for (affine::AffineForOp nestedOp : llvm::make_early_inc_range(
+           forOp.getRegion().getOps<affine::AffineForOp>()))
+    carryUPDOpsAcrossIterations(nestedOp, state);
+
+  if (!forOp.hasConstantBounds() ||
+      forOp.getConstantUpperBound() <= forOp.getConstantLowerBound())
+    return;
+  Value iv = forOp.getInductionVar();
+
+  // Memrefs written in the loop, whose loads cannot be carried over
+  llvm::SmallPtrSet<Value, 4> writtenMemRefs;
+  forOp.walk([&](Operation *op) {
+    if (auto writeOp = dyn_cast<TransferWriteOp>(op))
+      writtenMemRefs.insert(writeOp.getSource());
+    else if (auto storeOp = dyn_cast<affine::AffineStoreOp>(op))
+      writtenMemRefs.insert(storeOp.getMemRef());
+    else if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+      writtenMemRefs.insert(storeOp.getMemRef());
+  });
+
+  SmallVector<std::pair<aievec::UPDOp, aievec::UPDOp>> carriedUpdOps;
+  SmallVector<Value> initValues;
+  Value lb;
+  for (auto updOp : forOp.getBody()->getOps<aievec::UPDOp>()) {
+    // Find the idx=1 upd op that completes the idx=0 upd op of an interval
+    auto prevUpdOp = updOp.getVector()
+                         ? updOp.getVector().getDefiningOp<aievec::UPDOp>()
+                         : nullptr;
+    if (updOp.getIndex() != 1 || !prevUpdOp || prevUpdOp.getIndex() != 0 ||
+        prevUpdOp->getBlock() != forOp.getBody() ||
+        prevUpdOp.getSource() != updOp.getSource())
+      continue;
+
+    Value memref = updOp.getSource();
+    auto memRefType = dyn_cast<MemRefType>(memref.getType());
+    if (!memRefType || !memRefType.getLayout().isIdentity() ||
+        writtenMemRefs.contains(memref) ||
+        !forOp.isDefinedOutsideOfLoop(memref))
+      continue;
+
+    // The loop must advance the innermost index by exactly one half of the
+    // interval.
+    auto vecType = cast<VectorType>(updOp.getResult().getType());
+    int32_t halfWidth = getVectorSizeInBits(vecType) / 2;
+    if (forOp.getStepAsInt() * getElementSizeInBits(vecType) != halfWidth ||
+        !getOffsetFromInductionVar(prevUpdOp.getIndices().back(), iv))
+      continue;
+
+    // Load the idx=0 half of the first iteration before the loop
+    state->builder.setInsertionPoint(forOp);
+    if (!lb)
+      lb = state->builder.create<arith::ConstantIndexOp>(
+          forOp.getLoc(), forOp.getConstantLowerBound());
+    SmallVector<Value, 4> indices;
+    if (!getFirstIterationIndices(prevUpdOp, forOp, lb, indices, state))
+      continue;
+    auto initOp = state->builder.create<aievec::UPDOp>(
+        prevUpdOp.getLoc(), vecType, memref, indices, prevUpdOp.getOffset(),
+        0);
+
+    LLVM_DEBUG(llvm::dbgs() << "\n\nCarrying upd op " << updOp
+                            << " across iterations of " << forOp);
+
+    carriedUpdOps.emplace_back(prevUpdOp, updOp);
+    initValues.push_back(initOp.getResult());
+  }
+  if (carriedUpdOps.empty())
+    return;
+
+  // Move the idx=1 half of each carried interval to its lower half to form
+  // the idx=0 half of the next iteration.
+  SmallVector<Value> yieldValues;
+  for (auto [prevUpdOp, updOp] : carriedUpdOps) {
+    auto vecType = cast<VectorType>(updOp.getResult().getType());
+    unsigned halfLanes = getVectorLaneSize(vecType) / 2;
+    VectorType halfType = createVectorType(halfLanes, vecType.getElementType());
+    state->builder.setInsertionPointAfter(updOp);
+    Value hi;
+    if (state->aieml)
+      hi = state->builder.create<aievec::ExtOp>(updOp.getLoc(), halfType,
+                                                updOp.getResult(), 1);
+    else
+      hi = generateExtOp(updOp.getResult(), halfLanes, 1, state,
+                         updOp.getLoc());
+    SmallVector<Value> sources = {hi, hi};
+    yieldValues.push_back(
+        generateConcatOp(sources, state, updOp.getLoc(), vecType));
+  }
+
+  IRRewriter rewriter(forOp.getContext());
+  auto newLoop = cast<LoopLikeOpInterface>(forOp.getOperation())
+                     .replaceWithAdditionalYields(
+                         rewriter, initValues,
+                         /*replaceInitOperandUsesInLoop=*/false,
+                         [&](OpBuilder &, Location, ArrayRef<BlockArgument>) {
+                           return yieldValues;
+                         });
+  assert(succeeded(newLoop) && "failed to add loop-carried upd values");
+  auto iterArgs = newLoop->getRegionIterArgs().take_back(carriedUpdOps.size());
+  for (auto [carried, iterArg] : llvm::zip(carriedUpdOps, iterArgs)) {
+    aievec::UPDOp prevUpdOp = carried.first;
+    prevUpdOp.getResult().replaceAllUsesWith(iterArg);
+    prevUpdOp->erase();
+  }
+}
+
+// Carry the overlapping half of sliding-window loads across loop iterations
+// in the function.
+static void carryUPDOpsAcrossIterationsInFunc(func::FuncOp func,
+                                              VectState *state) {
+  for (affine::AffineForOp forOp :
+       llvm::make_early_inc_range(func.getOps<affine::AffineForOp>()))
+    carryUPDOpsAcrossIterations(forOp, state);
+}
+
 // Incoming Op is an operation in AIE dialect whose result is an accumulator.
 // Check all its uses, and if any user of Op is a non-AIE operation, insert an
 // SRS instruction to move the value from accumulator to vector.
@@ -3053,6 +3235,10 @@ void AIEVectorize::runOnOperation() {
     // FMA_Conv.
     if (state->aieml)
       fuseMulFMAOpsByMulFMAConv(func, state);
+    // Reuse the loads of sliding windows across iterations of the vectorized
+    // loop.
+    if (crossIterationReuse)
+      carryUPDOpsAcrossIterationsInFunc(func, state);
   }
 
   // Canonicalize the IR of all the functions in the module by running a set of
@@ -0,0 +1,405 @@
+//===- AffineVectorizeForAIEVec.cpp - Cost-driven affine vectorization ----===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements the affine vectorization step of the AIEVec flow. It
+// vectorizes innermost affine loops like the affine super-vectorizer, but
+// picks the vector width of each loop with a cost model of the AIE2/AIE2P
+// vector unit instead of a single virtual vector size given by the user.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+
+#include "mlir/Dialect/Affine/Analysis/AffineAnalysis.h"
+#include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Affine/Utils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Pass/PassManager.h"
+
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+
+#include <algorithm>
+
+#define DEBUG_TYPE "affine-vectorize-for-aievec"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+static AIEArch decodeAIETarget(const std::string &target) {
+  if (target == "aieml" || target == "aie2")
+    return AIEArch::AIE2;
+  if (target == "aie2p")
+    return AIEArch::AIE2P;
+  return AIEArch::UNKNOWN;
+}
+
+//============================================================================//
+//============================ Vector unit model =============================//
+//============================================================================//
+
+namespace {
+
+// Throughput and register file of the AIE2/AIE2P vector unit, as seen by
+// elementwise code. All widths are in bits.
+struct VectorUnitModel {
+  AIEArch arch;
+
+  // Vector registers and accumulator registers, in 512-bit units.
+  static constexpr unsigned numVectorRegs = 12;
+  static constexpr unsigned numAccRegs = 8;
+  // Two 256-bit load ports and one 256-bit store port per cycle.
+  static constexpr unsigned loadBits = 512;
+  static constexpr unsigned storeBits = 256;
+  // Vector ALU operations work on one 512-bit register per cycle.
+  static constexpr unsigned aluBits = 512;
+  // UPS/SRS move one 1024-bit accumulator per cycle.
+  static constexpr unsigned shiftRoundBits = 1024;
+  // Branch and address updates not hidden by the VLIW schedule.
+  static constexpr double loopOverhead = 1.0;
+
+  // Returns the lanes one elementwise multiply or MAC instruction computes
+  // for multiplicands of type `elemTy` accumulating at `accBits` per lane,
+  // and the number of instructions it takes; {0, 0} if there is no such
+  // mode. The wider AIE2P bf16 MAC only makes wide vectors cheaper, and
+  // wide vectors already win on AIE2 unless another slot is the
+  // bottleneck, so both targets pick the same widths; only the estimated
+  // cycles differ.
+  std::pair<unsigned, unsigned> getMacShape(Type elemTy,
+                                            unsigned accBits) const {
+    if (elemTy.isBF16())
+      return {arch == AIEArch::AIE2P ? 32 : 16, 1};
+    // f32 is emulated with three bf16 MACs per lane group.
+    if (elemTy.isF32())
+      return {16, 3};
+    auto intTy = dyn_cast<IntegerType>(elemTy);
+    if (!intTy)
+      return {0, 0};
+    switch (intTy.getWidth()) {
+    case 8:
+      return accBits == 32 ? std::make_pair(32u, 1u) : std::make_pair(0u, 0u);
+    case 16:
+      return accBits == 32 ? std::make_pair(32u, 1u) : std::make_pair(16u, 1u);
+    case 32:
+      // i32 is emulated with four i16 MACs into acc64.
+      return accBits == 64 ? std::make_pair(16u, 4u) : std::make_pair(0u, 0u);
+    default:
+      return {0, 0};
+    }
+  }
+
+  // Returns the accumulator widths a multiply of `elemTy` operands producing
+  // `resTy` lanes can use.
+  SmallVector<unsigned> getAccBitsCandidates(Type elemTy, Type resTy) const {
+    if (isa<FloatType>(elemTy))
+      return {32};
+    unsigned elemBits = elemTy.getIntOrFloatBitWidth();
+    unsigned resBits = resTy.getIntOrFloatBitWidth();
+    if (resBits > elemBits)
+      return {resBits > 32 ? 64u : 32u};
+    if (elemBits == 16)
+      return {32, 64};
+    return {elemBits == 32 ? 64u : 32u};
+  }
+};
+
+// A multiply in a loop body, with the element type of its multiplicands
+// before any extension and the type of its result.
+struct MulInfo {
+  Type elemTy;
+  Type resTy;
+};
+
+// The width-independent part of the cost of a loop body: what it loads,
+// stores and computes per scalar iteration.
+struct LoopBodySummary {
+  SmallVector<Type> loads;
+  SmallVector<Type> stores;
+  SmallVector<MulInfo> muls;
+  // Element types of elementwise operations that run on the vector ALU.
+  SmallVector<Type> aluOps;
+  // Accumulator values narrowed to a vector type (SRS) and vector values
+  // widened into an accumulator (UPS).
+  unsigned numSRS = 0;
+  unsigned numUPS = 0;
+
+  // Returns the narrowest and widest element type loaded or stored.
+  std::pair<unsigned, unsigned> getMemoryBitWidthRange() const {
+    unsigned minBits = ~0u, maxBits = 0;
+    for (Type ty : llvm::concat<const Type>(loads, stores)) {
+      minBits = std::min(minBits, ty.getIntOrFloatBitWidth());
+      maxBits = std::max(maxBits, ty.getIntOrFloatBitWidth());
+    }
+    return {minBits, maxBits};
+  }
+};
+
+// Result of scoring one vector width for a loop.
+struct VectorWidthCost {
+  int64_t width;
+  // Estimated cycles per scalar iteration of the original loop.
+  double cyclesPerElement;
+};
+
+} // namespace
+
+static bool isVectorizableElementType(Type type) {
+  return type.isInteger(8) || type.isInteger(16) || type.isInteger(32) ||
+         type.isBF16() || type.isF32();
+}
+
+static unsigned ceilDiv(uint64_t a, uint64_t b) { return (a + b - 1) / b; }
+
+// Collects the summary of an innermost loop body. Returns std::nullopt if
+// the body does not touch memory through vectorizable element types.
+static std::optional<LoopBodySummary>
+summarizeLoopBody(affine::AffineForOp loop) {
+  LoopBodySummary summary;
+  for (Operation &op : loop.getBody()->without_terminator()) {
+    if (auto load = dyn_cast<affine::AffineLoadOp>(op)) {
+      Type elemTy = load.getMemRefType().getElementType();
+      if (isVectorizableElementType(elemTy))
+        summary.loads.push_back(elemTy);
+      continue;
+    }
+    if (auto store = dyn_cast<affine::AffineStoreOp>(op)) {
+      Type elemTy = store.getMemRefType().getElementType();
+      if (isVectorizableElementType(elemTy))
+        summary.stores.push_back(elemTy);
+      continue;
+    }
+    if (op.getNumResults() != 1 ||
+        (!isVectorizableElementType(op.getResult(0).getType()) &&
+         !op.getResult(0).getType().isInteger(64)))
+      continue;
+
+    if (isa<arith::MulIOp, arith::MulFOp>(op)) {
+      // Extensions of the multiplicands are folded into the multiply.
+      Type elemTy = op.getResult(0).getType();
+      if (auto *def = op.getOperand(0).getDefiningOp();
+          def && isa<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp>(def))
+        elemTy = def->getOperand(0).getType();
+      summary.muls.push_back({elemTy, op.getResult(0).getType()});
+      continue;
+    }
+    if (isa<arith::AddIOp, arith::AddFOp, arith::SubIOp, arith::SubFOp>(op)) {
+      // An add of a multiply result is the accumulate half of a MAC.
+      if (llvm::any_of(op.getOperands(), [](Value v) {
+            return v.getDefiningOp<arith::MulIOp>() ||
+                   v.getDefiningOp<arith::MulFOp>();
+          }))
+        continue;
+      summary.aluOps.push_back(op.getResult(0).getType());
+      continue;
+    }
+    if (isa<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp>(op)) {
+      if (llvm::all_of(op.getUsers(), [](Operation *user) {
+            return isa<arith::MulIOp, arith::MulFOp>(user);
+          }))
+        continue;
+      summary.numUPS++;
+      continue;
+    }
+    if (isa<arith::TruncIOp, arith::TruncFOp>(op)) {
+      summary.numSRS++;
+      continue;
+    }
+    if (op.getDialect() == loop->getDialect() ||
+        isa<arith::ConstantOp>(op))
+      continue;
+    summary.aluOps.push_back(op.getResult(0).getType());
+  }
+  if (summary.loads.empty() && summary.stores.empty())
+    return std::nullopt;
+  return summary;
+}
+
+// Estimates the cycles per scalar iteration of a loop vectorized by `width`
+// with `accBits`-wide accumulators. The vectorized body is assumed to be
+// software pipelined, so an iteration costs as much as its busiest VLIW
+// slot, plus spills when its vectors do not fit in the register file.
+static std::optional<double>
+estimateCyclesPerElement(const VectorUnitModel &model,
+                         const LoopBodySummary &summary, int64_t width,
+                         unsigned accBits) {
+  double mulSlot = 0;
+  unsigned accRegs = 0;
+  for (const MulInfo &mul : summary.muls) {
+    auto [lanes, instrs] = model.getMacShape(mul.elemTy, accBits);
+    if (!lanes)
+      return std::nullopt;
+    mulSlot += ceilDiv(width, lanes) * instrs;
+    accRegs += ceilDiv(width * accBits, 512);
+  }
+
+  double aluSlot = 0;
+  for (Type ty : summary.aluOps)
+    aluSlot += ceilDiv(width * ty.getIntOrFloatBitWidth(), model.aluBits);
+
+  unsigned accShifts = ceilDiv(width * accBits, model.shiftRoundBits);
+  double loadSlot = summary.numUPS * accShifts;
+  unsigned vectorRegs = 0;
+  for (Type ty : summary.loads) {
+    unsigned bits = width * ty.getIntOrFloatBitWidth();
+    loadSlot += static_cast<double>(bits) / model.loadBits;
+    vectorRegs += ceilDiv(bits, 512);
+  }
+  double storeSlot = summary.numSRS * accShifts;
+  for (Type ty : summary.stores)
+    storeSlot += ceilDiv(width * ty.getIntOrFloatBitWidth(), model.storeBits);
+
+  // Every register over the budget is spilled and reloaded once.
+  unsigned spills = 0;
+  if (vectorRegs > model.numVectorRegs)
+    spills += vectorRegs - model.numVectorRegs;
+  if (accRegs > model.numAccRegs)
+    spills += (accRegs - model.numAccRegs) * 2;
+  loadSlot += spills;
+  storeSlot += spills;
+
+  double cycles = std::max({mulSlot, aluSlot, loadSlot, storeSlot}) +
+                  model.loopOverhead;
+  return cycles / width;
+}
+
+// Scores every candidate width for `loop` and returns the cheapest, or
+// std::nullopt if no width is feasible. Ties go to the wider vector. A width
+// costs as much as its cheapest accumulator mode; the mode itself is picked
+// again by convert-vector-to-aievec from the vector types, so it is not kept.
+static std::optional<VectorWidthCost>
+selectVectorWidth(const VectorUnitModel &model, affine::AffineForOp loop,
+                  const LoopBodySummary &summary) {
+  auto [minBits, maxBits] = summary.getMemoryBitWidthRange();
+  std::optional<uint64_t> tripCount = affine::getConstantTripCount(loop);
+
+  // The accumulator mode is shared by all multiplies in the body, so it is
+  // chosen from the first one.
+  SmallVector<unsigned> accBitsCandidates{32};
+  if (!summary.muls.empty())
+    accBitsCandidates = model.getAccBitsCandidates(summary.muls[0].elemTy,
+                                                   summary.muls[0].resTy);
+
+  std::optional<VectorWidthCost> best;
+  for (int64_t width : {8, 16, 32, 64}) {
+    // The narrowest memory vector must fit in one register and be at least
+    // 128 bits; the widest (an accumulator being stored) may span two. The
+    // width must also divide a known trip count.
+    if (width * minBits < 128 || width * minBits > 512 ||
+        width * maxBits > 1024)
+      continue;
+    if (tripCount && *tripCount % width != 0)
+      continue;
+    for (unsigned accBits : accBitsCandidates) {
+      auto cost = estimateCyclesPerElement(model, summary, width, accBits);
+      if (!cost)
+        continue;
+      LLVM_DEBUG(llvm::dbgs() << "  width " << width << ", acc" << accBits
+                              << ": " << *cost << " cycles/element\n");
+      if (!best || *cost <= best->cyclesPerElement)
+        best = VectorWidthCost{width, *cost};
+    }
+  }
+  return best;
+}
+
+//============================================================================//
+//=============================== Vectorization ==============================//
+//============================================================================//
+
+namespace {
+
+struct AffineVectorizeForAIEVecPass
+    : public PassWrapper<AffineVectorizeForAIEVecPass,
+                         OperationPass<func::FuncOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(AffineVectorizeForAIEVecPass)
+
+  AffineVectorizeForAIEVecPass() = default;
+  AffineVectorizeForAIEVecPass(const AffineVectorizeForAIEVecPass &pass)
+      : PassWrapper(pass) {}
+
+  AffineVectorizeForAIEVecPass(const AffineVectorizeForAIEVecOptions &options)
+      : AffineVectorizeForAIEVecPass() {
+    aieTarget = options.aieTarget;
+  }
+
+  StringRef getArgument() const final { return "aievec-affine-vectorize"; }
+
+  StringRef getDescription() const final {
+    return "Vectorize innermost affine loops with a width chosen by an AIE "
+           "cost model";
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<affine::AffineDialect, arith::ArithDialect,
+                    vector::VectorDialect>();
+  }
+
+  Option<std::string> aieTarget{
+      *this, "aie-target",
+      llvm::cl::desc("Select AIE version: \"aie2\" or \"aie2p\". This will "
+                     "determine the cost model used to pick vector widths."),
+      llvm::cl::init("aie2")};
+
+  void runOnOperation() override {
+    func::FuncOp func = getOperation();
+    AIEArch aieVersion = decodeAIETarget(aieTarget);
+    if (aieVersion == AIEArch::UNKNOWN) {
+      func->emitError() << "unknown AIE target '" << aieTarget << "'";
+      signalPassFailure();
+      return;
+    }
+    VectorUnitModel model{aieVersion};
+
+    // Innermost parallel loops, grouped by the width chosen for them.
+    llvm::MapVector<int64_t, DenseSet<Operation *>> loopsByWidth;
+    affine::ReductionLoopMap reductionLoops;
+    func.walk([&](affine::AffineForOp loop) {
+      if (!loop.getBody()->getOps<affine::AffineForOp>().empty())
+        return;
+      SmallVector<affine::LoopReduction, 2> reductions;
+      if (!affine::isLoopParallel(loop, &reductions))
+        return;
+      auto summary = summarizeLoopBody(loop);
+      if (!summary)
+        return;
+      LLVM_DEBUG(llvm::dbgs() << "scoring loop at " << loop.getLoc() << "\n");
+      auto best = selectVectorWidth(model, loop, *summary);
+      if (!best)
+        return;
+      LLVM_DEBUG(llvm::dbgs() << "  selected width " << best->width << "\n");
+      loopsByWidth[best->width].insert(loop);
+      if (!reductions.empty())
+        reductionLoops[loop] = reductions;
+    });
+
+    for (auto &[width, loops] : loopsByWidth)
+      affine::vectorizeAffineLoops(func, loops, {width},
+                                   /*fastestVaryingPattern=*/{},
+                                   reductionLoops);
+  }
+};
+
+} // namespace
+
+static std::unique_ptr<::mlir::Pass> createAffineVectorizeForAIEVecPass(
+    const AffineVectorizeForAIEVecOptions &options) {
+  return std::make_unique<AffineVectorizeForAIEVecPass>(options);
+}
+
+//============================================================================//
+//=============== Affine vectorization Pipeline Configuration ================//
+//============================================================================//
+
+void xilinx::aievec::buildAffineVectorizeForAIEVec(
+    OpPassManager &pm, const AffineVectorizeForAIEVecOptions &options) {
+  pm.addNestedPass<func::FuncOp>(createAffineVectorizeForAIEVecPass(options));
+}
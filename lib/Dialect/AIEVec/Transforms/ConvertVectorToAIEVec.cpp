@@ -151,6 +151,13 @@ void xilinx::aievec::registerAIEVecPipelines() {
       "architecture.",
       buildConvertVectorToAIEVec);
 
+  PassPipelineRegistration<AffineVectorizeForAIEVecOptions>(
+      "affine-vectorize-for-aievec",
+      "This pass pipeline vectorizes affine loops, picking the vector width "
+      "of each loop with a cost model of the selected AIE vector "
+      "architecture.",
+      buildAffineVectorizeForAIEVec);
+
   PassPipelineRegistration<CanonicalizeVectorForAIEVecOptions>(
       "canonicalize-vector-for-aievec",
       "This pass pipeline takes standard \"Vector\" code and converts it to "
@@ -0,0 +1,443 @@
+//===- SplitReductionAccumulators.cpp - Multi-accumulator reductions -----===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements a transformation that keeps loop-carried reductions in
+// vector accumulators. A scalar accumulator that reduces a whole vector on
+// every iteration is replaced by a vector accumulator that is reduced only
+// once, after the loop. Vector accumulators are then split into several
+// independent partial accumulators, so that consecutive accumulations in the
+// loop body do not wait on each other and can be software pipelined.
+//
+// Both steps reorder the accumulation. This is always done for integer and
+// floating-point min/max reductions; floating-point add and mul reductions are
+// only rewritten if their accumulating op has the `reassoc` fast-math flag.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+
+#include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Affine/LoopUtils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "split-reduction-accumulators"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+//============================================================================//
+//================================= Helpers ==================================//
+//============================================================================//
+
+// Returns the combining kind of an elementwise op that can carry a reduction.
+static std::optional<vector::CombiningKind> getCombiningKind(Operation *op) {
+  using vector::CombiningKind;
+  return llvm::TypeSwitch<Operation *, std::optional<CombiningKind>>(op)
+      .Case<arith::AddIOp, arith::AddFOp>(
+          [](auto) { return CombiningKind::ADD; })
+      .Case<arith::MulIOp, arith::MulFOp>(
+          [](auto) { return CombiningKind::MUL; })
+      .Case<arith::MaxSIOp>([](auto) { return CombiningKind::MAXSI; })
+      .Case<arith::MaxUIOp>([](auto) { return CombiningKind::MAXUI; })
+      .Case<arith::MinSIOp>([](auto) { return CombiningKind::MINSI; })
+      .Case<arith::MinUIOp>([](auto) { return CombiningKind::MINUI; })
+      .Case<arith::MaximumFOp>([](auto) { return CombiningKind::MAXIMUMF; })
+      .Case<arith::MinimumFOp>([](auto) { return CombiningKind::MINIMUMF; })
+      .Case<arith::MaxNumFOp>([](auto) { return CombiningKind::MAXNUMF; })
+      .Case<arith::MinNumFOp>([](auto) { return CombiningKind::MINNUMF; })
+      .Case<arith::AndIOp>([](auto) { return CombiningKind::AND; })
+      .Case<arith::OrIOp>([](auto) { return CombiningKind::OR; })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
+// Returns the atomic kind whose identity value is the identity of `kind` on
+// `elemTy` elements.
+static std::optional<arith::AtomicRMWKind>
+getAtomicRMWKind(vector::CombiningKind kind, Type elemTy) {
+  using vector::CombiningKind;
+  bool isFloat = isa<FloatType>(elemTy);
+  switch (kind) {
+  case CombiningKind::ADD:
+    return isFloat ? arith::AtomicRMWKind::addf : arith::AtomicRMWKind::addi;
+  case CombiningKind::MUL:
+    return isFloat ? arith::AtomicRMWKind::mulf : arith::AtomicRMWKind::muli;
+  case CombiningKind::MAXSI:
+    return arith::AtomicRMWKind::maxs;
+  case CombiningKind::MAXUI:
+    return arith::AtomicRMWKind::maxu;
+  case CombiningKind::MINSI:
+    return arith::AtomicRMWKind::mins;
+  case CombiningKind::MINUI:
+    return arith::AtomicRMWKind::minu;
+  case CombiningKind::MAXIMUMF:
+    return arith::AtomicRMWKind::maximumf;
+  case CombiningKind::MINIMUMF:
+    return arith::AtomicRMWKind::minimumf;
+  case CombiningKind::MAXNUMF:
+    return arith::AtomicRMWKind::maxnumf;
+  case CombiningKind::MINNUMF:
+    return arith::AtomicRMWKind::minnumf;
+  case CombiningKind::AND:
+    return arith::AtomicRMWKind::andi;
+  case CombiningKind::OR:
+    return arith::AtomicRMWKind::ori;
+  default:
+    return std::nullopt;
+  }
+}
+
+// Creates a vector of type `vecTy` with the identity value of `kind` in every
+// lane. The caller must have checked that `kind` has an identity.
+static Value createIdentityVector(OpBuilder &b, Location loc,
+                                  vector::CombiningKind kind,
+                                  VectorType vecTy) {
+  Type elemTy = vecTy.getElementType();
+  TypedAttr identity = arith::getIdentityValueAttr(
+      *getAtomicRMWKind(kind, elemTy), elemTy, b, loc);
+  return b.create<arith::ConstantOp>(loc, vecTy,
+                                     DenseElementsAttr::get(vecTy, identity));
+}
+
+// Returns the fast-math flags of `op`, or nullptr if it has none.
+static arith::FastMathFlagsAttr getFastMathFlags(Operation *op) {
+  if (auto fmi = dyn_cast<arith::ArithFastMathInterface>(op))
+    return fmi.getFastMathFlagsAttr();
+  return nullptr;
+}
+
+// Returns true if the accumulation of `kind` done by `op` on `elemTy`
+// elements may be reordered.
+static bool isReassociable(Operation *op, vector::CombiningKind kind,
+                           Type elemTy) {
+  using vector::CombiningKind;
+  if (!isa<FloatType>(elemTy) ||
+      (kind != CombiningKind::ADD && kind != CombiningKind::MUL))
+    return true;
+  auto fmf = getFastMathFlags(op);
+  return fmf && arith::bitEnumContainsAll(fmf.getValue(),
+                                          arith::FastMathFlags::reassoc);
+}
+
+static std::optional<int64_t> getConstantTripCount(LoopLikeOpInterface loop) {
+  if (auto forOp = dyn_cast<affine::AffineForOp>(*loop)) {
+    if (auto tripCount = affine::getConstantTripCount(forOp))
+      return static_cast<int64_t>(*tripCount);
+    return std::nullopt;
+  }
+  auto forOp = cast<scf::ForOp>(*loop);
+  auto lb = getConstantIntValue(forOp.getLowerBound());
+  auto ub = getConstantIntValue(forOp.getUpperBound());
+  auto step = getConstantIntValue(forOp.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return std::nullopt;
+  return *ub <= *lb ? 0 : llvm::divideCeil(*ub - *lb, *step);
+}
+
+static LogicalResult unrollLoop(LoopLikeOpInterface loop, uint64_t factor) {
+  if (auto forOp = dyn_cast<affine::AffineForOp>(*loop))
+    return affine::loopUnrollByFactor(forOp, factor);
+  if (failed(loopUnrollByFactor(cast<scf::ForOp>(*loop), factor)))
+    return failure();
+  return success();
+}
+
+static bool isInnermostLoop(LoopLikeOpInterface loop) {
+  bool innermost = true;
+  for (Region &region : loop->getRegions())
+    region.walk([&](LoopLikeOpInterface) {
+      innermost = false;
+      return WalkResult::interrupt();
+    });
+  return innermost;
+}
+
+//============================================================================//
+//========================= Scalar to vector reductions ======================//
+//============================================================================//
+
+// A scalar loop accumulator updated on every iteration with the reduction of
+// a vector, either as `vector.reduction <kind>, %v, %acc` or as
+// `%acc <kind> vector.reduction <kind>, %v`.
+struct ScalarReduction {
+  unsigned iterArgIdx;
+  vector::ReductionOp reductionOp;
+  // Elementwise op combining the reduced vector with the accumulator, if the
+  // accumulator is not an operand of the reduction itself.
+  Operation *combineOp;
+};
+
+static std::optional<ScalarReduction>
+matchScalarReduction(LoopLikeOpInterface loop, unsigned idx) {
+  BlockArgument iterArg = loop.getRegionIterArgs()[idx];
+  Value yielded = loop.getYieldedValues()[idx];
+  if (isa<VectorType>(iterArg.getType()) || !iterArg.hasOneUse() ||
+      !yielded.hasOneUse())
+    return std::nullopt;
+  Operation *accOp = yielded.getDefiningOp();
+  if (!accOp || accOp != *iterArg.user_begin() ||
+      accOp->getBlock() != iterArg.getOwner())
+    return std::nullopt;
+
+  ScalarReduction red{idx, nullptr, nullptr};
+  if (auto reductionOp = dyn_cast<vector::ReductionOp>(accOp)) {
+    if (reductionOp.getAcc() != iterArg)
+      return std::nullopt;
+    red.reductionOp = reductionOp;
+  } else {
+    auto kind = getCombiningKind(accOp);
+    if (!kind)
+      return std::nullopt;
+    Value partial = accOp->getOperand(accOp->getOperand(0) == iterArg ? 1 : 0);
+    auto reductionOp = partial.getDefiningOp<vector::ReductionOp>();
+    if (!reductionOp || reductionOp.getAcc() ||
+        reductionOp.getKind() != *kind || !partial.hasOneUse() ||
+        reductionOp->getBlock() != iterArg.getOwner())
+      return std::nullopt;
+    red.reductionOp = reductionOp;
+    red.combineOp = accOp;
+  }
+
+  auto vecTy = cast<VectorType>(red.reductionOp.getVector().getType());
+  vector::CombiningKind kind = red.reductionOp.getKind();
+  if (!getAtomicRMWKind(kind, vecTy.getElementType()) ||
+      !isReassociable(accOp, kind, vecTy.getElementType()))
+    return std::nullopt;
+  return red;
+}
+
+// Carries the vectors reduced by `red` in a new vector accumulator, and
+// reduces that accumulator into the scalar one after the loop. The scalar
+// accumulator is left passing its initial value through the loop; it is
+// cleaned up by canonicalization.
+static void vectorizeScalarReduction(IRRewriter &rewriter,
+                                     LoopLikeOpInterface &loop,
+                                     const ScalarReduction &red) {
+  vector::ReductionOp reductionOp = red.reductionOp;
+  vector::CombiningKind kind = reductionOp.getKind();
+  Value vec = reductionOp.getVector();
+  Location loc = reductionOp.getLoc();
+  Operation *accOp = red.combineOp ? red.combineOp : reductionOp;
+  unsigned accOperandIdx = loop.getRegionIterArgs()[red.iterArgIdx]
+                               .getUses()
+                               .begin()
+                               ->getOperandNumber();
+  Value init = loop.getInits()[red.iterArgIdx];
+  unsigned numResults = loop->getNumResults();
+
+  rewriter.setInsertionPoint(loop);
+  Value identity = createIdentityVector(rewriter, loc, kind,
+                                        cast<VectorType>(vec.getType()));
+  auto newLoop = loop.replaceWithAdditionalYields(
+      rewriter, identity, /*replaceInitOperandUsesInLoop=*/false,
+      [&](OpBuilder &b, Location, ArrayRef<BlockArgument> newBbArgs) {
+        accOp->getResult(0).replaceAllUsesWith(
+            accOp->getOperand(accOperandIdx));
+        return SmallVector<Value>{
+            vector::makeArithReduction(b, loc, kind, vec, newBbArgs.front(),
+                                       getFastMathFlags(accOp))};
+      });
+  if (red.combineOp)
+    rewriter.eraseOp(red.combineOp);
+  rewriter.eraseOp(reductionOp);
+  loop = *newLoop;
+
+  rewriter.setInsertionPointAfter(loop);
+  Value reduced = rewriter.create<vector::ReductionOp>(
+      loc, kind, loop->getResult(numResults), init);
+  rewriter.replaceAllUsesWith(loop->getResult(red.iterArgIdx), reduced);
+}
+
+//============================================================================//
+//========================== Accumulator splitting ===========================//
+//============================================================================//
+
+// Returns the combining kind of the vector accumulator `idx` of `loop` if it
+// is only updated by a single elementwise op whose result is yielded.
+static std::optional<vector::CombiningKind>
+matchVectorAccumulator(LoopLikeOpInterface loop, unsigned idx) {
+  BlockArgument iterArg = loop.getRegionIterArgs()[idx];
+  Value yielded = loop.getYieldedValues()[idx];
+  auto vecTy = dyn_cast<VectorType>(iterArg.getType());
+  if (!vecTy || !iterArg.hasOneUse() || !yielded.hasOneUse())
+    return std::nullopt;
+  Operation *accOp = yielded.getDefiningOp();
+  if (!accOp || accOp != *iterArg.user_begin() ||
+      accOp->getBlock() != iterArg.getOwner())
+    return std::nullopt;
+  auto kind = getCombiningKind(accOp);
+  if (!kind || !getAtomicRMWKind(*kind, vecTy.getElementType()) ||
+      !isReassociable(accOp, *kind, vecTy.getElementType()))
+    return std::nullopt;
+  return kind;
+}
+
+// Returns the ops updating the accumulator `idx` of `loop`, in order.
+static SmallVector<Operation *> getAccumulatorChain(LoopLikeOpInterface loop,
+                                                   unsigned idx) {
+  SmallVector<Operation *> chain;
+  Value acc = loop.getRegionIterArgs()[idx];
+  while (acc.hasOneUse()) {
+    Operation *user = *acc.user_begin();
+    if (user->hasTrait<OpTrait::IsTerminator>())
+      break;
+    chain.push_back(user);
+    acc = user->getResult(0);
+  }
+  return chain;
+}
+
+// Gives each op in `chain`, which is the unrolled update of the accumulator
+// `idx` of `loop`, its own accumulator. The partial accumulators are combined
+// after the loop.
+static void splitAccumulator(IRRewriter &rewriter, LoopLikeOpInterface &loop,
+                             unsigned idx, vector::CombiningKind kind,
+                             ArrayRef<Operation *> chain) {
+  Location loc = chain.front()->getLoc();
+  auto vecTy = cast<VectorType>(loop.getRegionIterArgs()[idx].getType());
+  unsigned numResults = loop->getNumResults();
+
+  rewriter.setInsertionPoint(loop);
+  Value identity = createIdentityVector(rewriter, loc, kind, vecTy);
+  SmallVector<Value> inits(chain.size() - 1, identity);
+  auto newLoop = loop.replaceWithAdditionalYields(
+      rewriter, inits, /*replaceInitOperandUsesInLoop=*/false,
+      [&](OpBuilder &, Location, ArrayRef<BlockArgument> newBbArgs) {
+        chain.back()->getResult(0).replaceAllUsesWith(
+            chain.front()->getResult(0));
+        SmallVector<Value> yielded;
+        for (auto [i, partial] : llvm::enumerate(newBbArgs)) {
+          chain[i + 1]->replaceUsesOfWith(chain[i]->getResult(0), partial);
+          yielded.push_back(chain[i + 1]->getResult(0));
+        }
+        return yielded;
+      });
+  loop = *newLoop;
+
+  rewriter.setInsertionPointAfter(loop);
+  Value result = loop->getResult(idx);
+  Value combined = result;
+  Operation *firstCombineOp = nullptr;
+  arith::FastMathFlagsAttr fastmath = getFastMathFlags(chain.front());
+  for (Value partial : loop->getResults().drop_front(numResults)) {
+    combined = vector::makeArithReduction(rewriter, loc, kind, combined,
+                                          partial, fastmath);
+    if (!firstCombineOp)
+      firstCombineOp = combined.getDefiningOp();
+  }
+  result.replaceAllUsesExcept(combined, firstCombineOp);
+}
+
+//============================================================================//
+//=============================== Reduction Pass =============================//
+//============================================================================//
+
+namespace {
+
+struct SplitReductionAccumulatorsPass
+    : public PassWrapper<SplitReductionAccumulatorsPass, OperationPass<>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(SplitReductionAccumulatorsPass)
+
+  SplitReductionAccumulatorsPass() = default;
+  SplitReductionAccumulatorsPass(const SplitReductionAccumulatorsPass &pass)
+      : PassWrapper(pass) {}
+
+  SplitReductionAccumulatorsPass(unsigned numAccumulators)
+      : SplitReductionAccumulatorsPass() {
+    this->numAccumulators = numAccumulators;
+  }
+
+  StringRef getArgument() const final {
+    return "test-split-reduction-accumulators";
+  }
+
+  StringRef getDescription() const final {
+    return "Keep loop-carried reductions in several independent vector "
+           "accumulators";
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<affine::AffineDialect, arith::ArithDialect,
+                    scf::SCFDialect, vector::VectorDialect>();
+  }
+
+  Option<unsigned> numAccumulators{
+      *this, "reduction-accumulators",
+      llvm::cl::desc("Number of independent accumulators each loop-carried "
+                     "vector reduction is split into"),
+      llvm::cl::init(4)};
+
+  void runOnOperation() override {
+    SmallVector<LoopLikeOpInterface> loops;
+    getOperation()->walk([&](LoopLikeOpInterface loop) {
+      if (isa<affine::AffineForOp, scf::ForOp>(*loop) && isInnermostLoop(loop))
+        loops.push_back(loop);
+    });
+
+    IRRewriter rewriter(&getContext());
+    for (LoopLikeOpInterface loop : loops)
+      splitReductions(rewriter, loop);
+  }
+
+private:
+  void splitReductions(IRRewriter &rewriter, LoopLikeOpInterface loop) {
+    unsigned numIterArgs = loop.getRegionIterArgs().size();
+    for (unsigned idx = 0; idx < numIterArgs; ++idx)
+      if (auto red = matchScalarReduction(loop, idx))
+        vectorizeScalarReduction(rewriter, loop, *red);
+
+    SmallVector<std::pair<unsigned, vector::CombiningKind>> accumulators;
+    for (unsigned idx = 0, e = loop.getRegionIterArgs().size(); idx < e; ++idx)
+      if (auto kind = matchVectorAccumulator(loop, idx))
+        accumulators.emplace_back(idx, *kind);
+    if (accumulators.empty())
+      return;
+
+    // Each partial accumulator is updated by one copy of the unrolled loop
+    // body. Only unroll by factors that leave no remainder iterations and at
+    // least two iterations of the unrolled loop.
+    auto tripCount = getConstantTripCount(loop);
+    if (!tripCount)
+      return;
+    int64_t factor = numAccumulators;
+    while (factor > 1 && (*tripCount % factor || *tripCount / factor < 2))
+      --factor;
+    if (factor < 2)
+      return;
+    LLVM_DEBUG(llvm::dbgs() << "splitting " << accumulators.size()
+                            << " accumulators of loop at " << loop.getLoc()
+                            << " " << factor << " ways\n");
+    if (failed(unrollLoop(loop, factor)))
+      return;
+
+    SmallVector<SmallVector<Operation *>> chains;
+    for (auto &acc : accumulators)
+      chains.push_back(getAccumulatorChain(loop, acc.first));
+    for (auto [acc, chain] : llvm::zip(accumulators, chains))
+      if (static_cast<int64_t>(chain.size()) == factor)
+        splitAccumulator(rewriter, loop, acc.first, acc.second, chain);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<::mlir::Pass>
+xilinx::aievec::createSplitReductionAccumulatorsPass(unsigned numAccumulators) {
+  return std::make_unique<SplitReductionAccumulatorsPass>(numAccumulators);
+}
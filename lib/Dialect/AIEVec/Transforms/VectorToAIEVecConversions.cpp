@@ -2259,6 +2259,64 @@ struct ComputeErfOpPattern : OpConversionPattern<math::ErfOp> {
   }
 };
 
+// Convert math.log and math.log1p to a function call to compute log(x) and
+// log(1 + x) for v16bfloat16 and v32bfloat16 types
+template <typename SrcOpTy>
+struct ComputeLogOpPattern : OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy logOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto srcType = dyn_cast<VectorType>(logOp.getOperand().getType());
+    if (!srcType)
+      return failure();
+
+    Type scalarType = srcType.getElementType();
+    if (!isa<FloatType>(scalarType))
+      return failure();
+
+    unsigned laneSize = getVectorLaneSize(srcType);
+    unsigned elWidth = scalarType.getIntOrFloatBitWidth();
+    if (elWidth != 16 || (laneSize != 16 && laneSize != 32))
+      return failure();
+
+    StringRef includeName = "vec_math.h";
+    auto moduleOp = logOp->template getParentOfType<mlir::ModuleOp>();
+    rewriter.setInsertionPointToStart(
+        &moduleOp.getRegion().getBlocks().front());
+    rewriter.create<emitc::IncludeOp>(moduleOp.getLoc(), includeName, false);
+
+    rewriter.setInsertionPoint(logOp);
+    Type vLNbf16OpaqueTy;
+    if (laneSize == 16)
+      vLNbf16OpaqueTy =
+          emitc::OpaqueType::get(rewriter.getContext(), "v16bfloat16");
+    else
+      vLNbf16OpaqueTy =
+          emitc::OpaqueType::get(rewriter.getContext(), "v32bfloat16");
+    auto opaquedOperand =
+        rewriter
+            .create<UnrealizedConversionCastOp>(logOp.getLoc(), vLNbf16OpaqueTy,
+                                                adaptor.getOperand())
+            .getResult(0);
+    SmallVector<Value> logOperands = {opaquedOperand};
+    StringRef funcName =
+        std::is_same_v<SrcOpTy, math::Log1pOp> ? "getLog1pBf16" : "getLogBf16";
+    auto callOp = rewriter.create<emitc::CallOpaqueOp>(
+        logOp.getLoc(), TypeRange{vLNbf16OpaqueTy}, funcName, nullptr, nullptr,
+        logOperands);
+    rewriter.replaceOpWithNewOp<UnrealizedConversionCastOp>(
+        logOp, TypeRange{logOp.getResult().getType()}, callOp.getResults());
+
+    return success();
+  }
+};
+
+using ComputeLogFOpPattern = ComputeLogOpPattern<math::LogOp>;
+using ComputeLog1pFOpPattern = ComputeLogOpPattern<math::Log1pOp>;
+
 // Convert math.absf and math.absi to a function call to compute abs(x) for
 // v16bfloat16, v32bfloat16, v16float, v16int32, v32int16 and v64int8 types
 template <typename SrcOpTy>
@@ -2586,6 +2644,218 @@ struct ComputeSigmoidOpPattern : OpConversionPattern<arith::DivFOp> {
   }
 };
 
+enum class GeluApproximation { None, Erf, Tanh };
+
+// Return true if `value` is a splat floating-point constant equal to
+// `expected` up to bfloat16 precision.
+static bool isSplatFloatConstant(Value value, float expected) {
+  auto constOp = value.getDefiningOp<arith::ConstantOp>();
+  if (!constOp)
+    return false;
+
+  auto cstDense = dyn_cast<DenseFPElementsAttr>(constOp.getValue());
+  if (!cstDense || !cstDense.isSplat())
+    return false;
+
+  float cstValue = cstDense.getSplatValue<APFloat>().convertToFloat();
+  return std::abs(cstValue - expected) <= 1e-2f * std::abs(expected);
+}
+
+// Collect the factors of the product rooted at `value`, looking through the
+// single-use arith.mulf ops that compute it. Those ops are appended to
+// `chainOps`, users before producers.
+static void collectMulFFactors(Value value, SmallVectorImpl<Value> &factors,
+                               SmallVectorImpl<Operation *> &chainOps) {
+  auto mulOp = value.getDefiningOp<arith::MulFOp>();
+  if (!mulOp || !mulOp->hasOneUse()) {
+    factors.push_back(value);
+    return;
+  }
+  chainOps.push_back(mulOp);
+  collectMulFFactors(mulOp.getLhs(), factors, chainOps);
+  collectMulFFactors(mulOp.getRhs(), factors, chainOps);
+}
+
+// Remove a splat constant factor equal to `expected` from `factors`, if any.
+static bool takeConstantFactor(SmallVectorImpl<Value> &factors,
+                               float expected) {
+  auto *it = llvm::find_if(
+      factors, [&](Value v) { return isSplatFloatConstant(v, expected); });
+  if (it == factors.end())
+    return false;
+  factors.erase(it);
+  return true;
+}
+
+// Match `erf(x / sqrt(2))` or `tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))`.
+static GeluApproximation
+matchGeluActivation(Value value, Value input,
+                    SmallVectorImpl<Operation *> &chainOps) {
+  Operation *defOp = value.getDefiningOp();
+  if (!defOp || !defOp->hasOneUse())
+    return GeluApproximation::None;
+
+  if (auto erfOp = dyn_cast<math::ErfOp>(defOp)) {
+    chainOps.push_back(erfOp);
+    SmallVector<Value> factors;
+    collectMulFFactors(erfOp.getOperand(), factors, chainOps);
+    if (factors.size() != 2 || !takeConstantFactor(factors, 0.70710678f) ||
+        factors[0] != input)
+      return GeluApproximation::None;
+    return GeluApproximation::Erf;
+  }
+
+  auto tanhOp = dyn_cast<math::TanhOp>(defOp);
+  if (!tanhOp)
+    return GeluApproximation::None;
+  chainOps.push_back(tanhOp);
+  SmallVector<Value> factors;
+  collectMulFFactors(tanhOp.getOperand(), factors, chainOps);
+  if (factors.size() != 2 || !takeConstantFactor(factors, 0.79788456f))
+    return GeluApproximation::None;
+
+  auto addOp = factors[0].getDefiningOp<arith::AddFOp>();
+  if (!addOp || !addOp->hasOneUse())
+    return GeluApproximation::None;
+  chainOps.push_back(addOp);
+  Value cube = addOp.getLhs() == input   ? addOp.getRhs()
+               : addOp.getRhs() == input ? addOp.getLhs()
+                                         : Value();
+  if (!cube)
+    return GeluApproximation::None;
+
+  SmallVector<Value> cubeFactors;
+  collectMulFFactors(cube, cubeFactors, chainOps);
+  if (cubeFactors.size() != 4 || !takeConstantFactor(cubeFactors, 0.044715f) ||
+      !llvm::all_of(cubeFactors, [&](Value v) { return v == input; }))
+    return GeluApproximation::None;
+  return GeluApproximation::Tanh;
+}
+
+// Check whether `mulOp` is the root of a GELU computation chain like-
+//      %0 = arith.mulf %x, %cst_rsqrt2 : vector<16xbf16>
+//      %1 = math.erf %0 : vector<16xbf16>
+//      %2 = arith.addf %1, %cst_1 : vector<16xbf16>
+//      %3 = arith.mulf %x, %2 : vector<16xbf16>
+//      %4 = arith.mulf %3, %cst_0_5 : vector<16xbf16>
+//
+// or of its tanh approximation, where %1 is computed by-
+//      %0 = arith.mulf %x, %x : vector<16xbf16>
+//      %1 = arith.mulf %0, %x : vector<16xbf16>
+//      %2 = arith.mulf %1, %cst_0_044715 : vector<16xbf16>
+//      %3 = arith.addf %x, %2 : vector<16xbf16>
+//      %4 = arith.mulf %3, %cst_sqrt_2_over_pi : vector<16xbf16>
+//      %5 = math.tanh %4 : vector<16xbf16>
+//
+// Operands of arith.mulf and arith.addf may appear in either order. On
+// success, `input` is set to %x and `chainOps` to the ops of the chain other
+// than `mulOp`, users before producers. Only the chains that can be lowered
+// to a function call are matched: erf for v16bfloat16 and v32bfloat16, tanh
+// for v16bfloat16.
+static GeluApproximation
+getLowerableGeluChain(arith::MulFOp mulOp, Value &input,
+                      SmallVectorImpl<Operation *> &chainOps) {
+  auto resultType = dyn_cast<VectorType>(mulOp.getType());
+  if (!resultType || resultType.getElementType().getIntOrFloatBitWidth() != 16)
+    return GeluApproximation::None;
+
+  unsigned laneSize = getVectorLaneSize(resultType);
+  if (laneSize != 16 && laneSize != 32)
+    return GeluApproximation::None;
+
+  SmallVector<Value> factors;
+  collectMulFFactors(mulOp.getLhs(), factors, chainOps);
+  collectMulFFactors(mulOp.getRhs(), factors, chainOps);
+  if (factors.size() != 3 || !takeConstantFactor(factors, 0.5f))
+    return GeluApproximation::None;
+
+  // The remaining factors are x and (1 + erf(...)) or (1 + tanh(...))
+  for (unsigned i = 0; i < 2; ++i) {
+    Value x = factors[i];
+    auto addOp = factors[1 - i].getDefiningOp<arith::AddFOp>();
+    if (!addOp || !addOp->hasOneUse())
+      continue;
+
+    Value activation;
+    if (isSplatFloatConstant(addOp.getLhs(), 1.0f))
+      activation = addOp.getRhs();
+    else if (isSplatFloatConstant(addOp.getRhs(), 1.0f))
+      activation = addOp.getLhs();
+    else
+      continue;
+
+    SmallVector<Operation *> activationOps = {addOp};
+    auto approx = matchGeluActivation(activation, x, activationOps);
+    if (approx == GeluApproximation::None ||
+        (approx == GeluApproximation::Tanh && laneSize != 16))
+      continue;
+
+    input = x;
+    chainOps.append(activationOps.begin(), activationOps.end());
+    return approx;
+  }
+
+  return GeluApproximation::None;
+}
+
+// Convert the GELU computation chain rooted at an arith.mulf to a function
+// call to compute gelu(x) for v16bfloat16 and v32bfloat16 types
+struct ComputeGeluOpPattern : OpConversionPattern<arith::MulFOp> {
+  // Take precedence over the lowering of arith.mulf to aievec.mul_elem
+  ComputeGeluOpPattern(MLIRContext *context)
+      : OpConversionPattern(context, /*benefit=*/2) {}
+
+  LogicalResult
+  matchAndRewrite(arith::MulFOp mulOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Value input;
+    SmallVector<Operation *> chainOps;
+    auto approx = getLowerableGeluChain(mulOp, input, chainOps);
+    if (approx == GeluApproximation::None)
+      return failure();
+
+    StringRef includeName;
+    StringRef funcName;
+    if (approx == GeluApproximation::Erf) {
+      includeName = "vec_math.h";
+      funcName = "getGeluErfBf16";
+    } else {
+      includeName = "lut_based_ops.h";
+      funcName = "getGeluTanhBf16";
+    }
+    auto moduleOp = mulOp->getParentOfType<mlir::ModuleOp>();
+    rewriter.setInsertionPointToStart(
+        &moduleOp.getRegion().getBlocks().front());
+    rewriter.create<emitc::IncludeOp>(moduleOp.getLoc(), includeName, false);
+
+    rewriter.setInsertionPoint(mulOp);
+    Type vecOpaqueTy;
+    if (getVectorLaneSize(cast<VectorType>(mulOp.getType())) == 16)
+      vecOpaqueTy =
+          emitc::OpaqueType::get(rewriter.getContext(), "v16bfloat16");
+    else
+      vecOpaqueTy =
+          emitc::OpaqueType::get(rewriter.getContext(), "v32bfloat16");
+    auto opaquedOperand =
+        rewriter
+            .create<UnrealizedConversionCastOp>(mulOp.getLoc(), vecOpaqueTy,
+                                                input)
+            .getResult(0);
+    SmallVector<Value> geluOperands = {opaquedOperand};
+    auto callOp = rewriter.create<emitc::CallOpaqueOp>(
+        mulOp.getLoc(), TypeRange{vecOpaqueTy}, funcName, nullptr, nullptr,
+        geluOperands);
+    rewriter.replaceOpWithNewOp<UnrealizedConversionCastOp>(
+        mulOp, TypeRange{mulOp.getType()}, callOp.getResults());
+
+    // The rest of the chain is now dead
+    for (Operation *op : chainOps)
+      rewriter.eraseOp(op);
+
+    return success();
+  }
+};
+
 // Convert math.ceil to a function call to compute ceil(x) for v16bfloat16
 struct ComputeCeilOpPattern : OpConversionPattern<math::CeilOp> {
   using OpConversionPattern::OpConversionPattern;
@@ -3108,6 +3378,9 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
       ComputeSqrtOpPattern,
       ComputeRsqrtOpPattern,
       ComputeErfOpPattern,
+      ComputeLogFOpPattern,
+      ComputeLog1pFOpPattern,
+      ComputeGeluOpPattern,
       ComputeAbsFOpPattern,
       ComputeAbsIOpPattern,
       ComputeSigmoidOpPattern,
@@ -3150,6 +3423,28 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
 
 // TODO: Review the validity of these legalizations beyond basic cases.
 
+// Return true if `op` is an inner op of a GELU computation chain that is
+// converted as a whole from its root arith.mulf, in which case it must be
+// left alone until the root is converted.
+static bool isInGeluChain(Operation *op) {
+  // The longest chain, the tanh approximation, has 8 ops above x^2
+  Operation *current = op;
+  for (unsigned i = 0; i < 8 && current->hasOneUse(); ++i) {
+    current = *current->getUsers().begin();
+    auto mulOp = dyn_cast<arith::MulFOp>(current);
+    if (!mulOp)
+      continue;
+
+    Value input;
+    SmallVector<Operation *> chainOps;
+    if (getLowerableGeluChain(mulOp, input, chainOps) !=
+            GeluApproximation::None &&
+        llvm::is_contained(chainOps, op))
+      return true;
+  }
+  return false;
+}
+
 static bool isInSigmoidOperationChain(math::ExpOp expOp) {
   if (!expOp.getOperand().getDefiningOp<arith::NegFOp>())
     return false;
@@ -3311,6 +3606,8 @@ static void configureAIEVecCommonLegalizations(ConversionTarget &target,
     auto srcType = dyn_cast<VectorType>(tanhOp.getOperand().getType());
     if (!srcType)
       return true;
+    if (isInGeluChain(tanhOp))
+      return true;
 
     Type scalarType = srcType.getElementType();
     if (!isa<FloatType>(scalarType))
@@ -3348,6 +3645,36 @@ static void configureAIEVecCommonLegalizations(ConversionTarget &target,
 
   target.addDynamicallyLegalOp<math::ErfOp>([](math::ErfOp erfOp) {
     auto srcType = dyn_cast<VectorType>(erfOp.getOperand().getType());
+    if (!srcType)
+      return true;
+    if (isInGeluChain(erfOp))
+      return true;
+
+    Type scalarType = srcType.getElementType();
+    if (!isa<FloatType>(scalarType))
+      return true;
+
+    unsigned laneSize = getVectorLaneSize(srcType);
+    unsigned elWidth = scalarType.getIntOrFloatBitWidth();
+    return elWidth != 16 || (laneSize != 16 && laneSize != 32);
+  });
+
+  target.addDynamicallyLegalOp<math::LogOp>([](math::LogOp logOp) {
+    auto srcType = dyn_cast<VectorType>(logOp.getOperand().getType());
+    if (!srcType)
+      return true;
+
+    Type scalarType = srcType.getElementType();
+    if (!isa<FloatType>(scalarType))
+      return true;
+
+    unsigned laneSize = getVectorLaneSize(srcType);
+    unsigned elWidth = scalarType.getIntOrFloatBitWidth();
+    return elWidth != 16 || (laneSize != 16 && laneSize != 32);
+  });
+
+  target.addDynamicallyLegalOp<math::Log1pOp>([](math::Log1pOp log1pOp) {
+    auto srcType = dyn_cast<VectorType>(log1pOp.getOperand().getType());
     if (!srcType)
       return true;
 
@@ -3613,6 +3940,8 @@ static void configureAIEVecV2Legalizations(ConversionTarget &target,
     auto resultType = dyn_cast<VectorType>(op.getType());
     if (!resultType)
       return true;
+    if (isInGeluChain(op))
+      return true;
 
     unsigned laneSize = getVectorLaneSize(resultType);
     return laneSize != 16;
@@ -3648,6 +3977,14 @@ static void configureAIEVecV2Legalizations(ConversionTarget &target,
     if (!resultType)
       return true;
 
+    // GELU computation chains are converted as a whole from their root
+    Value input;
+    SmallVector<Operation *> chainOps;
+    if (getLowerableGeluChain(op, input, chainOps) != GeluApproximation::None)
+      return false;
+    if (isInGeluChain(op))
+      return true;
+
     auto isAddOp = [&](Operation *op) { return isa<arith::AddFOp>(op); };
     // Verify it is not a part of FMA
     if (op->hasOneUse() && llvm::any_of(op->getUsers(), isAddOp))
@@ -21,6 +21,7 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Utils/ReshapeOpsUtils.h"
 #include "mlir/Dialect/Vector/Transforms/LoweringPatterns.h"
+#include "mlir/Dialect/Vector/Transforms/VectorRewritePatterns.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -672,6 +673,191 @@ struct ConvertLeadingUnitDimInsertToReshapePattern
   }
 };
 
+//============================================================================//
+//================== AIE2 contraction register blocking ======================//
+//============================================================================//
+
+// Returns the element type of `v` before it was widened by an `arith` cast.
+static Type getUnwidenedElementType(Value v) {
+  while (isa_and_present<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp>(
+      v.getDefiningOp()))
+    v = v.getDefiningOp()->getOperand(0);
+  return getElementTypeOrSelf(v.getType());
+}
+
+// Returns the {M, K, N} shape of the `aievec.matmul` that implements a
+// contraction of `lhsTy` and `rhsTy` elements into `accTy` elements on AIE2.
+static std::optional<std::array<int64_t, 3>>
+getAIE2MatMulShape(Type lhsTy, Type rhsTy, Type accTy) {
+  if (lhsTy.isBF16() && rhsTy.isBF16() && accTy.isF32())
+    return {{4, 8, 4}};
+  if (!isa<IntegerType>(lhsTy) || !isa<IntegerType>(rhsTy) ||
+      !isa<IntegerType>(accTy))
+    return std::nullopt;
+  unsigned lhsWidth = lhsTy.getIntOrFloatBitWidth();
+  unsigned rhsWidth = rhsTy.getIntOrFloatBitWidth();
+  unsigned accWidth = accTy.getIntOrFloatBitWidth();
+  if (accWidth == 32) {
+    if (lhsWidth == 8 && rhsWidth == 4)
+      return {{4, 16, 8}};
+    if (lhsWidth == 8 && rhsWidth == 8)
+      return {{4, 8, 8}};
+    if (lhsWidth == 16 && rhsWidth == 8)
+      return {{4, 4, 8}};
+    if (lhsWidth == 16 && rhsWidth == 16)
+      return {{4, 2, 8}};
+  } else if (accWidth == 64) {
+    if (lhsWidth == 16 && rhsWidth == 8)
+      return {{2, 8, 8}};
+    if (lhsWidth == 16 && rhsWidth == 16)
+      return {{2, 4, 8}};
+    if (lhsWidth == 32 && rhsWidth == 16)
+      return {{4, 2, 4}};
+  }
+  return std::nullopt;
+}
+
+// Returns the shape of the iteration space of a contraction that maps onto a
+// single `aievec.matmul`: every dimension is 1 except for the innermost M, K,
+// and N, which take the native matmul sizes for the operand types. Only
+// contractions where the innermost dimensions of LHS, RHS, and ACC are
+// (M, K), (K, N), and (M, N) respectively are considered.
+static std::optional<SmallVector<int64_t>>
+getContractionNativeShape(vector::ContractionOp contractOp) {
+  if (contractOp.getKind() != vector::CombiningKind::ADD)
+    return std::nullopt;
+  auto accTy = dyn_cast<VectorType>(contractOp.getAccType());
+  if (!accTy)
+    return std::nullopt;
+
+  auto getInnerDims =
+      [](AffineMap map) -> std::optional<std::pair<unsigned, unsigned>> {
+    unsigned numResults = map.getNumResults();
+    if (numResults < 2)
+      return std::nullopt;
+    auto outer = dyn_cast<AffineDimExpr>(map.getResult(numResults - 2));
+    auto inner = dyn_cast<AffineDimExpr>(map.getResult(numResults - 1));
+    if (!outer || !inner)
+      return std::nullopt;
+    return std::make_pair(outer.getPosition(), inner.getPosition());
+  };
+  auto indexingMaps = contractOp.getIndexingMapsArray();
+  auto lhsDims = getInnerDims(indexingMaps[0]);
+  auto rhsDims = getInnerDims(indexingMaps[1]);
+  auto accDims = getInnerDims(indexingMaps[2]);
+  if (!lhsDims || !rhsDims || !accDims)
+    return std::nullopt;
+  auto [mDim, kDim] = *lhsDims;
+  unsigned nDim = rhsDims->second;
+  if (rhsDims->first != kDim || accDims->first != mDim ||
+      accDims->second != nDim)
+    return std::nullopt;
+
+  auto matMulShape =
+      getAIE2MatMulShape(getUnwidenedElementType(contractOp.getLhs()),
+                         getUnwidenedElementType(contractOp.getRhs()),
+                         accTy.getElementType());
+  if (!matMulShape)
+    return std::nullopt;
+
+  SmallVector<int64_t> nativeShape(indexingMaps[0].getNumDims(), 1);
+  nativeShape[mDim] = (*matMulShape)[0];
+  nativeShape[kDim] = (*matMulShape)[1];
+  nativeShape[nDim] = (*matMulShape)[2];
+  return nativeShape;
+}
+
+// Returns the shape of the slice of operand `operandIdx` (0 for LHS, 1 for
+// RHS, and 2 for ACC) used by each native contraction `contractOp` is split
+// into.
+static std::optional<SmallVector<int64_t>>
+getContractionOperandTileShape(vector::ContractionOp contractOp,
+                               unsigned operandIdx) {
+  auto nativeShape = getContractionNativeShape(contractOp);
+  if (!nativeShape)
+    return std::nullopt;
+  AffineMap map = contractOp.getIndexingMapsArray()[operandIdx];
+  SmallVector<int64_t> tileShape;
+  for (AffineExpr expr : map.getResults())
+    tileShape.push_back(
+        (*nativeShape)[cast<AffineDimExpr>(expr).getPosition()]);
+  return tileShape;
+}
+
+// Returns the shape of the slices `v` is consumed in once the contractions
+// that use it, directly or through widening ops, have been split into native
+// contractions. Fails unless all uses agree on it.
+static std::optional<SmallVector<int64_t>> getConsumerTileShape(Value v) {
+  std::optional<SmallVector<int64_t>> tileShape;
+  for (OpOperand &use : v.getUses()) {
+    Operation *user = use.getOwner();
+    std::optional<SmallVector<int64_t>> userTileShape;
+    if (auto contractOp = dyn_cast<vector::ContractionOp>(user)) {
+      if (use.getOperandNumber() < 3)
+        userTileShape =
+            getContractionOperandTileShape(contractOp, use.getOperandNumber());
+    } else if (isa<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp>(user)) {
+      userTileShape = getConsumerTileShape(user->getResult(0));
+    } else if (auto extractOp = dyn_cast<vector::ExtractStridedSliceOp>(user)) {
+      // Slices already carved out for native contractions.
+      auto sliceShape = llvm::to_vector(extractOp.getType().getShape());
+      if (getConsumerTileShape(extractOp.getResult()) == sliceShape)
+        userTileShape = sliceShape;
+    }
+    if (!userTileShape || (tileShape && *tileShape != *userTileShape))
+      return std::nullopt;
+    tileShape = userTileShape;
+  }
+  return tileShape;
+}
+
+// Returns the shape of the slices the value written by `writeOp` is produced
+// in once the contraction computing it has been split into native
+// contractions.
+static std::optional<SmallVector<int64_t>>
+getProducerTileShape(vector::TransferWriteOp writeOp) {
+  Value vector = writeOp.getVector();
+  if (auto contractOp = vector.getDefiningOp<vector::ContractionOp>())
+    return getContractionOperandTileShape(contractOp, 2);
+  if (auto insertOp = vector.getDefiningOp<vector::InsertStridedSliceOp>())
+    if (insertOp.getSourceVectorType().getRank() ==
+        insertOp.getDestVectorType().getRank())
+      return llvm::to_vector(insertOp.getSourceVectorType().getShape());
+  return std::nullopt;
+}
+
+static std::optional<SmallVector<int64_t>>
+getRegisterBlockingNativeShape(Operation *op) {
+  if (auto contractOp = dyn_cast<vector::ContractionOp>(op))
+    return getContractionNativeShape(contractOp);
+  if (auto writeOp = dyn_cast<vector::TransferWriteOp>(op))
+    return getProducerTileShape(writeOp);
+  if (isa<vector::TransferReadOp, arith::ExtSIOp, arith::ExtUIOp,
+          arith::ExtFOp>(op))
+    return getConsumerTileShape(op->getResult(0));
+  return std::nullopt;
+}
+
+// Visit the reduction dimensions of a contraction in the outermost loops, so
+// that consecutive native contractions accumulate into different registers
+// and each operand slice is loaded once per reduction step.
+static std::optional<SmallVector<int64_t>>
+getRegisterBlockingTraversalOrder(Operation *op) {
+  auto contractOp = dyn_cast<vector::ContractionOp>(op);
+  if (!contractOp)
+    return std::nullopt;
+  SmallVector<int64_t> reductionDims, parallelDims;
+  for (auto [idx, iteratorType] :
+       llvm::enumerate(contractOp.getIteratorTypesArray())) {
+    if (iteratorType == vector::IteratorType::reduction)
+      reductionDims.push_back(idx);
+    else
+      parallelDims.push_back(idx);
+  }
+  reductionDims.append(parallelDims);
+  return reductionDims;
+}
+
 //============================================================================//
 //================ Common AIE canonicalization configuration =================//
 //============================================================================//
@@ -766,6 +952,37 @@ static std::unique_ptr<::mlir::Pass> createVectorBroadcastLoweringPass() {
   return std::make_unique<VectorBroadcastLoweringPass>();
 }
 
+// This pass splits contractions larger than the native `aievec.matmul` shape
+// into a block of native contractions, each one with its own accumulator. The
+// reads, widening ops, and writes around them are split along, so that each
+// slice of A and B is loaded once and reused by every native contraction in
+// the same row or column of the block, like the hand-written 2x2 kernels do.
+struct BlockContractionForAIE2Pass
+    : public PassWrapper<BlockContractionForAIE2Pass, OperationPass<>> {
+
+  void runOnOperation() override {
+    auto *op = getOperation();
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+
+    vector::populateVectorUnrollPatterns(
+        patterns,
+        vector::UnrollVectorOptions()
+            .setNativeShapeFn(getRegisterBlockingNativeShape)
+            .setUnrollTraversalOrderFn(getRegisterBlockingTraversalOrder));
+    vector::ExtractStridedSliceOp::getCanonicalizationPatterns(patterns,
+                                                               context);
+    vector::InsertStridedSliceOp::getCanonicalizationPatterns(patterns,
+                                                              context);
+
+    (void)applyPatternsAndFoldGreedily(op, std::move(patterns));
+  }
+};
+
+static std::unique_ptr<::mlir::Pass> createBlockContractionForAIE2Pass() {
+  return std::make_unique<BlockContractionForAIE2Pass>();
+}
+
 // This pass converts standard vector ops into a subset of `Vector` ops more
 // amenable to being converted to `AIEVec`. So far, this process consists of
 // two steps:
@@ -919,6 +1136,12 @@ void xilinx::aievec::buildCanonicalizeVectorForAIEVec(
   if (decodeTargetBackend(options.targetBackend) == TargetBackend::LLVMIR)
     pm.addPass(createReorderOperationsPass());
   pm.addPass(createCopyRemovalPass());
+  if (decodeAIETarget(options.aieTarget) == AIEArch::AIE2 &&
+      options.reductionAccumulators > 1)
+    pm.addPass(
+        createSplitReductionAccumulatorsPass(options.reductionAccumulators));
+  if (decodeAIETarget(options.aieTarget) == AIEArch::AIE2)
+    pm.addPass(createBlockContractionForAIE2Pass());
   pm.addPass(createVectorBroadcastLoweringPass());
   pm.addPass(createCanonicalizeVectorForAIEVecPass(options));
   if (decodeTargetBackend(options.targetBackend) == TargetBackend::CPP)
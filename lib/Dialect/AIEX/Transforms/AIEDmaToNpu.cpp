@@ -552,12 +552,14 @@ struct WriteBdToBlockWritePattern : OpConversionPattern<NpuWriteBdOp> {
   using OpConversionPattern::OpConversionPattern;
 
 private:
-  static int cachedId;
+  // Lowest suffix that may still be free for a blockwrite_data_ global. Owned
+  // by the pass run so that devices converted concurrently do not share it.
+  int &cachedId;
 
 public:
   WriteBdToBlockWritePattern(MLIRContext *context, int &cachedId,
                              PatternBenefit benefit = 1)
-      : OpConversionPattern(context, benefit) {}
+      : OpConversionPattern(context, benefit), cachedId(cachedId) {}
 
   LogicalResult
   matchAndRewrite(NpuWriteBdOp op, OpAdaptor adaptor,
@@ -716,8 +718,6 @@ public:
   }
 };
 
-int WriteBdToBlockWritePattern::cachedId = 0;
-
 struct AIEDmaToNpuPass : AIEDmaToNpuBase<AIEDmaToNpuPass> {
 
   void getDependentDialects(DialectRegistry &registry) const override {
@@ -727,6 +727,7 @@ struct AIEDmaToNpuPass : AIEDmaToNpuBase<AIEDmaToNpuPass> {
   void runOnOperation() override {
 
     ShimDMAllocationGetter cachingGetter;
+    int blockWriteDataId = 0;
 
     AIE::DeviceOp device = getOperation();
 
@@ -757,7 +758,8 @@ struct AIEDmaToNpuPass : AIEDmaToNpuBase<AIEDmaToNpuPass> {
     patterns.insert<PushQueuetoWrite32Pattern>(&getContext());
     patterns.insert<RtpToWrite32Pattern>(&getContext());
     patterns.insert<Write32SymToAddr>(&getContext());
-    patterns.insert<WriteBdToBlockWritePattern>(&getContext());
+    patterns.insert<WriteBdToBlockWritePattern>(&getContext(),
+                                                blockWriteDataId);
 
     if (failed(applyPartialConversion(device, target, std::move(patterns))))
       signalPassFailure();
@@ -0,0 +1,358 @@
+//===- AIENpuCleanup.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+#include <tuple>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// (column, row, register offset within the tile)
+using RegKey = std::tuple<int, int, uint32_t>;
+// (column, row, direction, channel)
+using ChanKey = std::tuple<int, int, int, int>;
+
+// Returns true if the register at 'offset' in tile (col, row) holds plain
+// state: tile data memory or a DMA buffer descriptor word. Writing such a
+// register has no effect other than changing its value, so an earlier write
+// may be dropped when a later one overwrites it. Everything else (task
+// queues, locks, core and DMA control) is treated as side-effecting.
+static bool isPlainRegister(const AIE::AIETargetModel &tm, int col, int row,
+                            uint32_t offset) {
+  if (tm.getTargetArch() == AIE::AIEArch::AIE1)
+    return false;
+  if (tm.isCoreTile(col, row))
+    return offset < tm.getLocalMemorySize() ||
+           (offset >= 0x1D000 && offset < 0x1D200);
+  if (tm.isMemTile(col, row))
+    return offset < tm.getMemTileSize() ||
+           (offset >= 0xA0000 && offset < 0xA0600);
+  if (tm.isShimNOCorPLTile(col, row))
+    return offset >= 0x1D000 && offset < 0x1D200;
+  return false;
+}
+
+// If 'offset' is a shim DMA task queue register, return the (direction,
+// channel) pair it pushes tasks onto. Direction uses the npu.sync encoding:
+// 0 is S2MM and 1 is MM2S.
+static std::optional<std::pair<int, int>>
+getShimTaskQueue(const AIE::AIETargetModel &tm, int col, int row,
+                 uint32_t offset) {
+  if (!tm.isShimNOCTile(col, row))
+    return std::nullopt;
+  switch (offset) {
+  case 0x1D204:
+    return std::make_pair(0, 0);
+  case 0x1D20C:
+    return std::make_pair(0, 1);
+  case 0x1D214:
+    return std::make_pair(1, 0);
+  case 0x1D21C:
+    return std::make_pair(1, 1);
+  default:
+    return std::nullopt;
+  }
+}
+
+// Resolve the tile-relative register targeted by a write op. Writes that are
+// still relative to a symbolic buffer cannot be resolved.
+template <typename OpT>
+static std::optional<RegKey> getRegKey(const AIE::AIETargetModel &tm,
+                                       OpT op) {
+  if (op.getBuffer())
+    return std::nullopt;
+  uint32_t address = op.getAddress();
+  if (op.getColumn() && op.getRow())
+    return RegKey{*op.getColumn(), *op.getRow(), address};
+  uint32_t colShift = tm.getColumnShift();
+  uint32_t rowShift = tm.getRowShift();
+  int col = address >> colShift;
+  int row = (address >> rowShift) & ((1u << (colShift - rowShift)) - 1);
+  return RegKey{col, row, address & ((1u << rowShift) - 1)};
+}
+
+// Last write seen to a plain register since the most recent barrier, and the
+// register value after it, if fully known.
+struct RegState {
+  Operation *lastWrite = nullptr;
+  std::optional<uint32_t> value;
+};
+
+// Task-complete-token bookkeeping for one DMA channel.
+struct ChanState {
+  // Tokens requested by task queue pushes that no npu.sync has waited on yet.
+  int outstanding = 0;
+  // A token-issuing push to this channel was seen in this sequence.
+  bool issued = false;
+  // The previous npu.sync on this channel consumed the last outstanding
+  // token and nothing was pushed since.
+  bool drained = false;
+  // Token count on this channel can no longer be tracked.
+  bool unknown = false;
+};
+
+struct NpuCleanup {
+  const AIE::AIETargetModel &tm;
+  llvm::DenseMap<RegKey, RegState> regs;
+  llvm::DenseMap<ChanKey, ChanState> chans;
+  // Set once an op that may push tasks in ways we cannot see is encountered.
+  bool tokensUnknown = false;
+  llvm::SetVector<Operation *> dead;
+  int numDeadWrites = 0;
+  int numRedundantSyncs = 0;
+
+  NpuCleanup(const AIE::AIETargetModel &tm) : tm(tm) {}
+
+  // Forget everything known about register contents. Used at points where
+  // earlier writes may be observed, such as npu.sync or a lock release.
+  void barrier() { regs.clear(); }
+
+  void kill(Operation *op) {
+    if (dead.insert(op))
+      numDeadWrites++;
+  }
+
+  // Returns true if 'op' may write the register 'key'. Ops already removed
+  // are ignored.
+  bool mayWrite(Operation *op, const RegKey &key) {
+    if (dead.contains(op))
+      return false;
+    return llvm::TypeSwitch<Operation *, bool>(op)
+        .Case<NpuWrite32Op, NpuMaskWrite32Op>([&](auto writeOp) {
+          auto writeKey = getRegKey(tm, writeOp);
+          return !writeKey || *writeKey == key;
+        })
+        .Case<NpuBlockWriteOp>([&](NpuBlockWriteOp writeOp) {
+          auto writeKey = getRegKey(tm, writeOp);
+          auto memrefTy = dyn_cast<MemRefType>(writeOp.getData().getType());
+          if (!writeKey || !memrefTy || !memrefTy.hasStaticShape())
+            return true;
+          auto [col, row, offset] = *writeKey;
+          uint32_t size = memrefTy.getNumElements() * sizeof(uint32_t);
+          return col == std::get<0>(key) && row == std::get<1>(key) &&
+                 std::get<2>(key) >= offset &&
+                 std::get<2>(key) < offset + size;
+        })
+        .Case<NpuSyncOp>([](auto) { return false; })
+        .Default([](Operation *op) { return !isMemoryEffectFree(op); });
+  }
+
+  // Returns true if no op strictly between 'from' and 'to' may write 'key',
+  // so that the effect of 'to' on it can be folded into 'from'.
+  bool canFoldInto(Operation *from, Operation *to, const RegKey &key) {
+    for (Operation *op = from->getNextNode(); op != to; op = op->getNextNode())
+      if (mayWrite(op, key))
+        return false;
+    return true;
+  }
+
+  void visitWrite32(NpuWrite32Op op) {
+    auto key = getRegKey(tm, op);
+    if (!key) {
+      barrier();
+      tokensUnknown = true;
+      return;
+    }
+    auto [col, row, offset] = *key;
+    uint32_t value = op.getValue();
+
+    if (!isPlainRegister(tm, col, row, offset)) {
+      barrier();
+      if (auto queue = getShimTaskQueue(tm, col, row, offset)) {
+        if (value & 0x80000000) {
+          ChanState &chan = chans[{col, row, queue->first, queue->second}];
+          chan.outstanding++;
+          chan.issued = true;
+          chan.drained = false;
+        }
+      }
+      return;
+    }
+
+    RegState &reg = regs[*key];
+    if (reg.value && *reg.value == value) {
+      kill(op);
+      return;
+    }
+    if (reg.lastWrite)
+      kill(reg.lastWrite);
+    reg.lastWrite = op;
+    reg.value = value;
+  }
+
+  void visitMaskWrite32(NpuMaskWrite32Op op) {
+    uint32_t mask = op.getMask();
+    if (mask == 0) {
+      kill(op);
+      return;
+    }
+    auto key = getRegKey(tm, op);
+    if (!key) {
+      barrier();
+      tokensUnknown = true;
+      return;
+    }
+    auto [col, row, offset] = *key;
+    if (!isPlainRegister(tm, col, row, offset)) {
+      barrier();
+      return;
+    }
+
+    uint32_t value = op.getValue() & mask;
+    RegState &reg = regs[*key];
+    OpBuilder builder(op);
+
+    // Folding moves the effect of this write up to the earlier one, which is
+    // only sound if nothing in between may write the same word.
+    if (reg.lastWrite && !canFoldInto(reg.lastWrite, op, *key)) {
+      reg.lastWrite = op;
+      reg.value.reset();
+      return;
+    }
+
+    // The full register value is known: fold into the earlier write32.
+    if (reg.value) {
+      uint32_t merged = (*reg.value & ~mask) | value;
+      if (merged != *reg.value) {
+        auto prev = cast<NpuWrite32Op>(reg.lastWrite);
+        prev.setValueAttr(builder.getUI32IntegerAttr(merged));
+        reg.value = merged;
+      }
+      kill(op);
+      return;
+    }
+
+    // Merge two masked writes to the same word into one.
+    if (auto prev = dyn_cast_if_present<NpuMaskWrite32Op>(reg.lastWrite)) {
+      uint32_t prevMask = prev.getMask();
+      uint32_t merged = (prev.getValue() & prevMask & ~mask) | value;
+      prev.setValueAttr(builder.getUI32IntegerAttr(merged));
+      prev.setMaskAttr(builder.getUI32IntegerAttr(prevMask | mask));
+      kill(op);
+      return;
+    }
+
+    reg.lastWrite = op;
+  }
+
+  void visitBlockWrite(NpuBlockWriteOp op) {
+    auto key = getRegKey(tm, op);
+    auto memrefTy = dyn_cast<MemRefType>(op.getData().getType());
+    if (!key || !memrefTy || !memrefTy.hasStaticShape()) {
+      barrier();
+      tokensUnknown = true;
+      return;
+    }
+    auto [col, row, offset] = *key;
+    uint32_t size = memrefTy.getNumElements() * sizeof(uint32_t);
+    if (!isPlainRegister(tm, col, row, offset) ||
+        !isPlainRegister(tm, col, row, offset + size - sizeof(uint32_t))) {
+      barrier();
+      tokensUnknown = true;
+      return;
+    }
+    // Earlier writes to words covered by the block are dead. The block
+    // contents are not tracked, so later writes do not kill the block.
+    for (uint32_t o = offset; o < offset + size; o += sizeof(uint32_t)) {
+      auto it = regs.find({col, row, o});
+      if (it == regs.end())
+        continue;
+      if (it->second.lastWrite)
+        kill(it->second.lastWrite);
+      regs.erase(it);
+    }
+  }
+
+  void visitAddressPatch(NpuAddressPatchOp op) {
+    // The patch rewrites a BD word at launch time from a value written
+    // earlier in the sequence, so it both reads and writes that word.
+    barrier();
+  }
+
+  void visitSync(NpuSyncOp op) {
+    barrier();
+    int col = op.getColumn(), row = op.getRow();
+    int dir = op.getDirection(), channel = op.getChannel();
+
+    if (op.getColumnNum() != 1 || op.getRowNum() != 1) {
+      for (int c = col; c < col + op.getColumnNum(); c++)
+        for (int r = row; r < row + op.getRowNum(); r++)
+          chans[{c, r, dir, channel}].unknown = true;
+      return;
+    }
+
+    ChanState &chan = chans[{col, row, dir, channel}];
+    if (chan.unknown || tokensUnknown)
+      return;
+    if (chan.outstanding > 0) {
+      chan.outstanding--;
+      chan.drained = chan.outstanding == 0 && chan.issued;
+      return;
+    }
+    // Every token this sequence requested on the channel has already been
+    // waited for; this sync could only wait on a token nobody issues.
+    if (chan.drained && dead.insert(op))
+      numRedundantSyncs++;
+  }
+
+  void run(Block &block) {
+    for (Operation &o : block) {
+      llvm::TypeSwitch<Operation *>(&o)
+          .Case<NpuWrite32Op>([&](auto op) { visitWrite32(op); })
+          .Case<NpuMaskWrite32Op>([&](auto op) { visitMaskWrite32(op); })
+          .Case<NpuBlockWriteOp>([&](auto op) { visitBlockWrite(op); })
+          .Case<NpuAddressPatchOp>([&](auto op) { visitAddressPatch(op); })
+          .Case<NpuSyncOp>([&](auto op) { visitSync(op); })
+          .Default([&](Operation *op) {
+            if (isMemoryEffectFree(op))
+              return;
+            barrier();
+            tokensUnknown = true;
+          });
+    }
+    for (Operation *op : dead)
+      op->erase();
+  }
+};
+
+struct AIENpuCleanupPass : AIENpuCleanupBase<AIENpuCleanupPass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    const AIE::AIETargetModel &tm = device.getTargetModel();
+
+    for (auto seq : device.getOps<RuntimeSequenceOp>()) {
+      if (seq.getBody().empty())
+        continue;
+      NpuCleanup cleanup(tm);
+      cleanup.run(seq.getBody().front());
+      numDeadWrites += cleanup.numDeadWrites;
+      numRedundantSyncs += cleanup.numRedundantSyncs;
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>> AIEX::createAIENpuCleanupPass() {
+  return std::make_unique<AIENpuCleanupPass>();
+}
@@ -16,10 +16,13 @@
 
 #include "mlir/Support/LogicalResult.h"
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/IR/AutoUpgrade.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/DiagnosticPrinter.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
@@ -32,6 +35,7 @@
 #include "llvm/Support/WithColor.h"
 #include "llvm/Transforms/IPO/Internalize.h"
 
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -66,7 +70,8 @@ static std::unique_ptr<Module> loadFile(std::unique_ptr<MemoryBuffer> Buffer,
 mlir::LogicalResult linkFiles(std::vector<std::string> Files,
                               LLVMContext &Context, Linker &L, unsigned Flags,
                               bool DisableDITypeMap, bool NoVerify,
-                              bool Internalize, bool Verbose) {
+                              bool Internalize, bool Verbose,
+                              StringSet<> *Roots = nullptr) {
   // Filter out flags that don't apply to the first file we load.
   unsigned ApplicableFlags = Flags & Linker::Flags::OverrideFromSrc;
   // Similar to some flags, internalization doesn't apply to the first file.
@@ -89,6 +94,13 @@ mlir::LogicalResult linkFiles(std::vector<std::string> Files,
       return mlir::failure();
     }
 
+    // The definitions visible outside the first file are what the linked
+    // module is for; everything else is only kept if they reach it.
+    if (Roots && &File == &Files.front())
+      for (GlobalValue &GV : maybeModule->global_values())
+        if (!GV.isDeclaration() && !GV.hasLocalLinkage())
+          Roots->insert(GV.getName());
+
     if (Verbose)
       errs() << "Linking in '" << File << "'\n";
 
@@ -119,11 +131,96 @@ mlir::LogicalResult linkFiles(std::vector<std::string> Files,
   return mlir::success();
 }
 
+// Remove the functions and globals of M that cannot be reached from Roots
+// (or from the llvm.* globals, such as llvm.used) through calls, address
+// uses, initializers or aliases, and report what was removed to Report.
+static void pruneUnreachable(Module &M, const StringSet<> &Roots,
+                             raw_ostream &Report) {
+  SmallPtrSet<GlobalValue *, 32> Live;
+  SmallVector<GlobalValue *> Worklist;
+  auto MarkLive = [&](GlobalValue *GV) {
+    if (Live.insert(GV).second)
+      Worklist.push_back(GV);
+  };
+  for (GlobalValue &GV : M.global_values())
+    if (Roots.contains(GV.getName()) || GV.getName().starts_with("llvm."))
+      MarkLive(&GV);
+
+  SmallPtrSet<Constant *, 32> Visited;
+  std::function<void(Value *)> Visit = [&](Value *V) {
+    if (auto *GV = dyn_cast<GlobalValue>(V)) {
+      MarkLive(GV);
+      return;
+    }
+    auto *C = dyn_cast<Constant>(V);
+    if (!C || !Visited.insert(C).second)
+      return;
+    for (Value *Op : C->operands())
+      Visit(Op);
+  };
+  while (!Worklist.empty()) {
+    GlobalValue *GV = Worklist.pop_back_val();
+    if (auto *F = dyn_cast<Function>(GV)) {
+      for (Instruction &I : instructions(*F))
+        for (Value *Op : I.operands())
+          Visit(Op);
+      if (F->hasPersonalityFn())
+        Visit(F->getPersonalityFn());
+    } else if (auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      if (Var->hasInitializer())
+        Visit(Var->getInitializer());
+    } else if (auto *Alias = dyn_cast<GlobalAlias>(GV)) {
+      Visit(Alias->getAliasee());
+    }
+  }
+
+  SmallVector<GlobalValue *> Dead;
+  for (GlobalValue &GV : M.global_values())
+    if (!Live.contains(&GV))
+      Dead.push_back(&GV);
+
+  const DataLayout &DL = M.getDataLayout();
+  unsigned NumFunctions = 0, NumGlobals = 0;
+  uint64_t DataBytes = 0;
+  for (GlobalValue *GV : Dead) {
+    if (GV->isDeclaration())
+      continue;
+    if (isa<Function>(GV)) {
+      Report << "removed function " << GV->getName() << "\n";
+      NumFunctions++;
+    } else if (auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      uint64_t Size = DL.getTypeAllocSize(Var->getValueType());
+      Report << "removed global " << GV->getName() << " (" << Size
+             << " bytes)\n";
+      NumGlobals++;
+      DataBytes += Size;
+    }
+  }
+  Report << "removed " << NumFunctions << " functions and " << NumGlobals
+         << " globals, freeing " << DataBytes << " bytes of data memory\n";
+
+  // Dead values may still refer to each other; cut those references before
+  // erasing any of them.
+  for (GlobalValue *GV : Dead) {
+    if (auto *F = dyn_cast<Function>(GV))
+      F->dropAllReferences();
+    else if (auto *Var = dyn_cast<GlobalVariable>(GV))
+      Var->dropAllReferences();
+    else
+      GV->dropAllReferences();
+  }
+  for (GlobalValue *GV : Dead) {
+    GV->replaceAllUsesWith(PoisonValue::get(GV->getType()));
+    GV->eraseFromParent();
+  }
+}
+
 mlir::LogicalResult
 xilinx::AIE::AIELLVMLink(llvm::raw_ostream &output,
                          std::vector<std::string> Files, bool DisableDITypeMap,
                          bool NoVerify, bool Internalize, bool OnlyNeeded,
-                         bool PreserveAssemblyUseListOrder, bool Verbose) {
+                         bool PreserveAssemblyUseListOrder, bool Verbose,
+                         llvm::raw_ostream *PruneReport) {
   LLVMContext Context;
 
   if (!DisableDITypeMap)
@@ -137,10 +234,14 @@ xilinx::AIE::AIELLVMLink(llvm::raw_ostream &output,
     Flags |= Linker::Flags::LinkOnlyNeeded;
 
   // First add all the regular input files
+  StringSet<> Roots;
   if (failed(linkFiles(Files, Context, L, Flags, DisableDITypeMap, NoVerify,
-                       Internalize, Verbose)))
+                       Internalize, Verbose, PruneReport ? &Roots : nullptr)))
     return mlir::failure();
 
+  if (PruneReport)
+    pruneUnreachable(*Composite, Roots, *PruneReport);
+
   Composite->print(output, nullptr, PreserveAssemblyUseListOrder);
   return mlir::success();
 }
@@ -12,11 +12,14 @@
 
 #include "mlir/Support/LogicalResult.h"
 
+#include "llvm/ADT/MapVector.h"
+
 extern "C" {
 #include "xaiengine/xaie_core.h"
 #include "xaiengine/xaie_dma.h"
 #include "xaiengine/xaie_elfloader.h"
 #include "xaiengine/xaie_interrupt.h"
+#include "xaiengine/xaie_io.h"
 #include "xaiengine/xaie_locks.h"
 #include "xaiengine/xaie_mem.h"
 #include "xaiengine/xaie_plif.h"
@@ -26,6 +29,7 @@ extern "C" {
 #include "xaiengine/xaiegbl_defs.h"
 }
 
+#include <deque>
 #include <filesystem>
 
 using namespace mlir;
@@ -53,6 +57,156 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
 
 namespace xilinx::AIE {
 
+RegisterKind getRegisterKind(const AIETargetModel &tm, uint64_t addr) {
+  if (tm.getTargetArch() != AIEArch::AIE2)
+    return RegisterKind::Volatile;
+  uint32_t colShift = tm.getColumnShift();
+  uint32_t rowShift = tm.getRowShift();
+  int col = addr >> colShift;
+  int row = (addr >> rowShift) & ((1u << (colShift - rowShift)) - 1);
+  uint32_t offset = addr & ((1u << rowShift) - 1);
+
+  if (tm.isCoreTile(col, row)) {
+    // 16KB of program memory.
+    if (offset >= 0x20000 && offset < 0x24000)
+      return RegisterKind::Program;
+    // Buffer descriptors and the stream switch.
+    if ((offset >= 0x1D000 && offset < 0x1D200) ||
+        (offset >= 0x3F000 && offset < 0x3F400))
+      return RegisterKind::Config;
+  } else if (tm.isMemTile(col, row)) {
+    if ((offset >= 0xA0000 && offset < 0xA0600) ||
+        (offset >= 0xB0000 && offset < 0xB0400))
+      return RegisterKind::Config;
+  } else if (tm.isShimNOCorPLTile(col, row)) {
+    // Stream switch and the shim mux/demux.
+    if ((offset >= 0x3F000 && offset < 0x3F400) || offset == 0x1F000 ||
+        offset == 0x1F004)
+      return RegisterKind::Config;
+  }
+  return RegisterKind::Volatile;
+}
+
+namespace {
+
+// Rewrites a list of transaction commands through a shadow copy of the
+// configuration and program memory registers. Writes to such registers are
+// buffered until the next command that may observe them, i.e. any write to a
+// volatile register or a block operation. They are then issued tile by tile,
+// in the order the tiles were first written, and in address order within each
+// tile so that runs of consecutive words become a single block write.
+// Volatile registers are never buffered or deduplicated.
+class WriteOptimizer {
+public:
+  WriteOptimizer(const AIETargetModel &tm) : tm(tm) {}
+
+  void add(const XAie_TxnCmd &cmd) {
+    bool isWrite = cmd.Opcode == XAie_TxnOpcode::XAIE_IO_WRITE;
+    if ((isWrite || cmd.Opcode == XAie_TxnOpcode::XAIE_IO_MASKWRITE) &&
+        getRegisterKind(tm, cmd.RegOff) != RegisterKind::Volatile) {
+      uint32_t mask = isWrite ? ~0u : cmd.Mask;
+      uint32_t value = cmd.Value & mask;
+      Word &shadowWord = shadow[cmd.RegOff];
+      if ((shadowWord.known & mask) == mask &&
+          (shadowWord.value & mask) == value) {
+        numDropped++;
+        return;
+      }
+      shadowWord.value = (shadowWord.value & ~mask) | value;
+      shadowWord.known |= mask;
+      Word &pendingWord =
+          pending[cmd.RegOff >> tm.getRowShift()][cmd.RegOff];
+      pendingWord.value = (pendingWord.value & ~mask) | value;
+      pendingWord.known |= mask;
+      return;
+    }
+
+    flush();
+    if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKWRITE) {
+      const u32 *data = reinterpret_cast<const u32 *>(cmd.DataPtr);
+      for (size_t i = 0; i < cmd.Size; i++)
+        setShadow(cmd.RegOff + i * 4, data[i]);
+    } else if (cmd.Opcode == XAie_TxnOpcode::XAIE_IO_BLOCKSET) {
+      for (size_t i = 0; i < cmd.Size; i++)
+        setShadow(cmd.RegOff + i * 4, cmd.Value);
+    }
+    cmds.push_back(cmd);
+  }
+
+  // Issue the buffered writes, sorted by address within each tile.
+  void flush() {
+    for (auto &tileWrites : pending)
+      flushTile(tileWrites.second);
+    pending.clear();
+  }
+
+  // Optimized commands. Block write payloads point into 'blocks' or into
+  // the commands passed to add().
+  std::vector<XAie_TxnCmd> cmds;
+  int numDropped = 0;
+
+private:
+  struct Word {
+    uint32_t value = 0;
+    uint32_t known = 0;
+  };
+
+  void flushTile(const std::map<uint64_t, Word> &writes) {
+    for (auto it = writes.begin(); it != writes.end();) {
+      uint64_t addr = it->first;
+      // The rest of the word may be known from earlier writes.
+      Word word = shadow[addr];
+      if (word.known != ~0u) {
+        word = it->second;
+        cmds.push_back(makeCmd(XAie_TxnOpcode::XAIE_IO_MASKWRITE, addr,
+                               word.value, word.known));
+        ++it;
+        continue;
+      }
+      // Collect the fully known words at consecutive addresses.
+      std::vector<u32> run;
+      for (; it != writes.end() && it->first == addr + run.size() * 4 &&
+             shadow[it->first].known == ~0u;
+           ++it)
+        run.push_back(shadow[it->first].value);
+      if (run.size() == 1) {
+        cmds.push_back(
+            makeCmd(XAie_TxnOpcode::XAIE_IO_WRITE, addr, run[0], 0));
+      } else {
+        XAie_TxnCmd cmd =
+            makeCmd(XAie_TxnOpcode::XAIE_IO_BLOCKWRITE, addr, 0, 0);
+        cmd.Size = run.size();
+        blocks.push_back(std::move(run));
+        cmd.DataPtr = reinterpret_cast<uint64_t>(blocks.back().data());
+        cmds.push_back(cmd);
+      }
+    }
+  }
+
+  void setShadow(uint64_t addr, uint32_t value) {
+    if (getRegisterKind(tm, addr) != RegisterKind::Volatile)
+      shadow[addr] = {value, ~0u};
+  }
+
+  static XAie_TxnCmd makeCmd(XAie_TxnOpcode opc, uint64_t addr, uint32_t value,
+                             uint32_t mask) {
+    XAie_TxnCmd cmd = {};
+    cmd.Opcode = opc;
+    cmd.RegOff = addr;
+    cmd.Value = value;
+    cmd.Mask = mask;
+    return cmd;
+  }
+
+  const AIETargetModel &tm;
+  llvm::DenseMap<uint64_t, Word> shadow;
+  // Buffered writes by tile, with 'known' holding the bits written.
+  llvm::MapVector<uint64_t, std::map<uint64_t, Word>> pending;
+  std::deque<std::vector<u32>> blocks;
+};
+
+} // namespace
+
 AIERTControl::AIERTControl(const AIE::BaseNPUTargetModel &tm)
     : targetModel(tm) {
   // The first column in the NPU lacks a shim tile.  AIE-RT exposes some of
@@ -590,6 +744,13 @@ LogicalResult AIERTControl::configureSwitches(DeviceOp &targetOp) {
 }
 
 LogicalResult AIERTControl::addInitConfig(DeviceOp &targetOp) {
+  if (!optimizeWrites)
+    return addInitConfigWrites(targetOp);
+  // Several flows, locks and BDs often write the same registers.
+  return addOptimizedWrites([&] { return addInitConfigWrites(targetOp); });
+}
+
+LogicalResult AIERTControl::addInitConfigWrites(DeviceOp &targetOp) {
 
   if (failed(initLocks(targetOp))) {
     return failure();
@@ -688,9 +849,12 @@ LogicalResult AIERTControl::addAieElf(uint8_t col, uint8_t row,
 }
 
 LogicalResult AIERTControl::addAieElfs(DeviceOp &targetOp,
-                                       const StringRef elfPath, bool aieSim) {
+                                       const StringRef elfPath, bool aieSim,
+                                       std::optional<int> col) {
   for (auto tileOp : targetOp.getOps<TileOp>())
-    if (tileOp.isShimNOCorPLTile()) {
+    if (col && tileOp.colIndex() != *col) {
+      // Handled by the instance loading that column
+    } else if (tileOp.isShimNOCorPLTile()) {
       // Resets no needed with V2 kernel driver
     } else {
       int col = tileOp.colIndex();
@@ -714,6 +878,83 @@ LogicalResult AIERTControl::addAieElfs(DeviceOp &targetOp,
   return success();
 }
 
+LogicalResult AIERTControl::replayTransaction(const XAie_TxnInst &txn) {
+  return replayCommands(ArrayRef<XAie_TxnCmd>(txn.CmdBuf, txn.NumCmds));
+}
+
+LogicalResult AIERTControl::replayCommands(ArrayRef<XAie_TxnCmd> cmds) {
+  for (const XAie_TxnCmd &cmd : cmds) {
+    switch (cmd.Opcode) {
+    case XAie_TxnOpcode::XAIE_IO_WRITE:
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_Write32, &devInst, cmd.RegOff,
+                                  cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_MASKWRITE:
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_MaskWrite32, &devInst, cmd.RegOff,
+                                  cmd.Mask, cmd.Value);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_BLOCKWRITE:
+      // Size is in words for block operations.
+      TRY_XAIE_API_LOGICAL_RESULT(
+          XAie_BlockWrite32, &devInst, cmd.RegOff,
+          reinterpret_cast<const u32 *>(cmd.DataPtr), cmd.Size);
+      break;
+    case XAie_TxnOpcode::XAIE_IO_BLOCKSET:
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_BlockSet32, &devInst, cmd.RegOff,
+                                  cmd.Value, cmd.Size);
+      break;
+    default:
+      llvm::errs() << "Cannot replay transaction opcode "
+                   << AIETXNOPCODETOSTR.at(cmd.Opcode) << "\n";
+      return failure();
+    }
+  }
+  return success();
+}
+
+// Take the commands recorded so far off the current transaction, optimize
+// them and reissue them through the IO backend, which is a fresh transaction
+// if 'restart' is set.
+static LogicalResult replayOptimized(AIERTControl &ctl, bool restart) {
+  XAie_TxnInst *txn = XAie_ExportTransactionInstance(&ctl.devInst);
+  XAie_ClearTransaction(&ctl.devInst);
+  ctl.inTransaction = false;
+  if (!txn)
+    return failure();
+
+  WriteOptimizer optimizer(ctl.targetModel);
+  for (size_t i = 0; i < txn->NumCmds; ++i)
+    optimizer.add(txn->CmdBuf[i]);
+  optimizer.flush();
+  LLVM_DEBUG(llvm::dbgs() << "Optimized " << txn->NumCmds << " commands to "
+                          << optimizer.cmds.size() << ", dropping "
+                          << optimizer.numDropped << " redundant writes\n");
+
+  if (restart)
+    ctl.startTransaction();
+  LogicalResult result = ctl.replayCommands(optimizer.cmds);
+  XAie_FreeTransactionInstance(txn);
+  return result;
+}
+
+LogicalResult AIERTControl::addOptimizedWrites(
+    llvm::function_ref<LogicalResult()> addWrites) {
+  if (inTransaction)
+    return addWrites();
+  startTransaction();
+  if (failed(addWrites())) {
+    XAie_ClearTransaction(&devInst);
+    inTransaction = false;
+    return failure();
+  }
+  return replayOptimized(*this, /*restart*/ false);
+}
+
+LogicalResult AIERTControl::optimizeTransaction() {
+  assert(inTransaction && "no transaction to optimize");
+  return replayOptimized(*this, /*restart*/ true);
+}
+
 void AIERTControl::dmaUpdateBdAddr(int col, int row, size_t addr, size_t bdId) {
   auto tileLoc = XAie_TileLoc(col, row);
   TRY_XAIE_API_FATAL_ERROR(XAie_DmaUpdateBdAddr, &devInst, tileLoc, addr, bdId);
@@ -722,6 +963,7 @@ void AIERTControl::dmaUpdateBdAddr(int col, int row, size_t addr, size_t bdId) {
 void AIERTControl::startTransaction() {
   TRY_XAIE_API_FATAL_ERROR(XAie_StartTransaction, &devInst,
                            XAIE_TRANSACTION_DISABLE_AUTO_FLUSH);
+  inTransaction = true;
 }
 
 void AIERTControl::exportSerializedTransaction() {
@@ -738,6 +980,9 @@ void AIERTControl::exportSerializedTransaction() {
     std::cout.flags(f);
     std::cout << "Mask: 0x" << std::hex << txnInst->CmdBuf[i].Mask << "\n";
   }
+  XAie_FreeTransactionInstance(txnInst);
+  XAie_ClearTransaction(&devInst);
+  inTransaction = false;
 }
 
 } // namespace xilinx::AIE
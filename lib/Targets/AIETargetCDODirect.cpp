@@ -18,6 +18,7 @@ extern "C" {
 #include "mlir/IR/Block.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 
@@ -40,6 +41,7 @@ extern "C" {
 extern "C" {
 #include "xaiengine/xaie_elfloader.h"
 #include "xaiengine/xaie_interrupt.h"
+#include "xaiengine/xaie_txn.h"
 #include "xaiengine/xaiegbl.h"
 }
 
@@ -73,10 +75,13 @@ generateCDOBinary(const StringRef outputPath,
   return success();
 }
 
+// Callback that adds the ELF loads of all cores to the current CDO.
+using AddElfsFn = std::function<LogicalResult()>;
+
 static LogicalResult generateCDOBinariesSeparately(AIERTControl &ctl,
                                                    const StringRef workDirPath,
                                                    DeviceOp &targetOp,
-                                                   bool aieSim,
+                                                   const AddElfsFn &addElfs,
                                                    bool enableCores) {
   auto ps = std::filesystem::path::preferred_separator;
 
@@ -84,9 +89,7 @@ static LogicalResult generateCDOBinariesSeparately(AIERTControl &ctl,
   if (failed(generateCDOBinary(
           (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo_elfs.bin")
               .str(),
-          [&ctl, &targetOp, &workDirPath, &aieSim] {
-            return ctl.addAieElfs(targetOp, workDirPath, aieSim);
-          })))
+          addElfs)))
     return failure();
 
   LLVM_DEBUG(llvm::dbgs() << "Generating aie_cdo_init.bin");
@@ -109,15 +112,15 @@ static LogicalResult generateCDOBinariesSeparately(AIERTControl &ctl,
 
 static LogicalResult generateCDOUnified(AIERTControl &ctl,
                                         const StringRef workDirPath,
-                                        DeviceOp &targetOp, bool aieSim,
+                                        DeviceOp &targetOp,
+                                        const AddElfsFn &addElfs,
                                         bool enableCores) {
   auto ps = std::filesystem::path::preferred_separator;
 
   return generateCDOBinary(
       (llvm::Twine(workDirPath) + std::string(1, ps) + "aie_cdo.bin").str(),
-      [&ctl, &targetOp, &workDirPath, &aieSim, &enableCores] {
-        if (!targetOp.getOps<CoreOp>().empty() &&
-            failed(ctl.addAieElfs(targetOp, workDirPath, aieSim)))
+      [&ctl, &targetOp, &addElfs, &enableCores] {
+        if (!targetOp.getOps<CoreOp>().empty() && failed(addElfs()))
           return failure();
         if (failed(ctl.addInitConfig(targetOp)))
           return failure();
@@ -128,10 +131,56 @@ static LogicalResult generateCDOUnified(AIERTControl &ctl,
       });
 }
 
+namespace {
+// Owns the transactions recorded for each column so they are released on
+// every exit path.
+struct ColumnTransactions {
+  SmallVector<XAie_TxnInst *> txns;
+  ~ColumnTransactions() {
+    for (XAie_TxnInst *txn : txns)
+      if (txn)
+        XAie_FreeTransactionInstance(txn);
+  }
+};
+} // namespace
+
+// Load the ELFs of each column that has cores with its own libxaie instance,
+// in parallel, recording the register writes as a transaction per column.
+// The CDO driver writes to a single global stream, so the transactions are
+// replayed into it afterwards, in ascending column order.
+static LogicalResult loadElfsByColumn(const BaseNPUTargetModel &targetModel,
+                                      DeviceOp &targetOp,
+                                      const StringRef workDirPath, bool aieSim,
+                                      ColumnTransactions &result) {
+  SmallVector<int> columns;
+  for (auto coreOp : targetOp.getOps<CoreOp>())
+    columns.push_back(coreOp.getTileOp().colIndex());
+  llvm::sort(columns);
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+  result.txns.assign(columns.size(), nullptr);
+  return failableParallelForEachN(
+      targetOp->getContext(), 0, columns.size(), [&](size_t i) {
+        AIERTControl colCtl(targetModel);
+        if (failed(colCtl.setIOBackend(aieSim, /*xaieDebug*/ false)))
+          return failure();
+        // Transactions are tracked per thread, so this captures only the
+        // writes made below.
+        colCtl.startTransaction();
+        if (failed(colCtl.addAieElfs(targetOp, workDirPath, aieSim,
+                                     columns[i])))
+          return failure();
+        result.txns[i] = XAie_ExportTransactionInstance(&colCtl.devInst);
+        XAie_ClearTransaction(&colCtl.devInst);
+        return success(result.txns[i] != nullptr);
+      });
+}
+
 static LogicalResult
 translateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
                      byte_ordering endianness, bool emitUnified, bool cdoDebug,
-                     bool aieSim, bool xaieDebug, bool enableCores) {
+                     bool aieSim, bool xaieDebug, bool enableCores,
+                     bool parallelColumns, bool optimizeWrites) {
 
   auto devOps = m.getOps<DeviceOp>();
   assert(llvm::range_size(devOps) == 1 &&
@@ -146,16 +195,35 @@ translateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
          "Only NPU currently supported");
 
   AIERTControl ctl(targetModel);
+  ctl.optimizeWrites = optimizeWrites;
   if (failed(ctl.setIOBackend(aieSim, xaieDebug)))
     return failure();
   initializeCDOGenerator(endianness, cdoDebug);
 
+  ColumnTransactions columnTxns;
+  AddElfsFn addElfs = [&] {
+    return ctl.addAieElfs(targetOp, workDirPath, aieSim);
+  };
+  // The libxaie debug backend prints as it goes, which would interleave
+  // between columns, so it always loads serially.
+  if (parallelColumns && !xaieDebug) {
+    if (failed(loadElfsByColumn(targetModel, targetOp, workDirPath, aieSim,
+                                columnTxns)))
+      return failure();
+    addElfs = [&] {
+      for (XAie_TxnInst *txn : columnTxns.txns)
+        if (failed(ctl.replayTransaction(*txn)))
+          return failure();
+      return success();
+    };
+  }
+
   auto result = [&]() {
     if (emitUnified) {
-      return generateCDOUnified(ctl, workDirPath, targetOp, aieSim,
+      return generateCDOUnified(ctl, workDirPath, targetOp, addElfs,
                                 enableCores);
     }
-    return generateCDOBinariesSeparately(ctl, workDirPath, targetOp, aieSim,
+    return generateCDOBinariesSeparately(ctl, workDirPath, targetOp, addElfs,
                                          enableCores);
   }();
   return result;
@@ -163,9 +231,11 @@ translateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
 
 LogicalResult xilinx::AIE::AIETranslateToCDODirect(
     ModuleOp m, llvm::StringRef workDirPath, bool bigEndian, bool emitUnified,
-    bool cdoDebug, bool aieSim, bool xaieDebug, bool enableCores) {
+    bool cdoDebug, bool aieSim, bool xaieDebug, bool enableCores,
+    bool parallelColumns, bool optimizeWrites) {
   byte_ordering endianness =
       bigEndian ? byte_ordering::Big_Endian : byte_ordering::Little_Endian;
   return translateToCDODirect(m, workDirPath, endianness, emitUnified, cdoDebug,
-                              aieSim, xaieDebug, enableCores);
+                              aieSim, xaieDebug, enableCores, parallelColumns,
+                              optimizeWrites);
 }
@@ -152,6 +152,13 @@ void registerAIETranslations() {
   static llvm::cl::opt<size_t> cdoEnableCores(
       "cdo-enable-cores", llvm::cl::init(true),
       llvm::cl::desc("Enable cores in CDO"));
+  static llvm::cl::opt<bool> cdoParallelColumns(
+      "cdo-parallel-columns", llvm::cl::init(false),
+      llvm::cl::desc("Load the ELFs of each column in parallel"));
+  static llvm::cl::opt<bool> cdoOptimizeWrites(
+      "cdo-optimize-writes", llvm::cl::init(false),
+      llvm::cl::desc("Drop redundant init config writes and batch the rest "
+                     "into block writes"));
 
   static llvm::cl::opt<bool> outputBinary(
       "aie-output-binary", llvm::cl::init(false),
@@ -340,7 +347,8 @@ void registerAIETranslations() {
         LLVM_DEBUG(llvm::dbgs() << "work-dir-path: " << workDirPath_ << "\n");
         return AIETranslateToCDODirect(module, workDirPath_.c_str(), bigEndian,
                                        cdoUnified, cdoDebug, cdoAieSim,
-                                       cdoXaieDebug, cdoEnableCores);
+                                       cdoXaieDebug, cdoEnableCores,
+                                       cdoParallelColumns, cdoOptimizeWrites);
       },
       registerDialects);
   TranslateFromMLIRRegistration registrationNPU(
@@ -86,7 +86,12 @@ PYBIND11_MODULE(_aie, m) {
   m.def(
       "translate_mlir_to_llvmir",
       [&stealCStr](MlirOperation op) {
-        return stealCStr(aieTranslateModuleToLLVMIR(op));
+        MlirStringRef llvmir;
+        {
+          py::gil_scoped_release release;
+          llvmir = aieTranslateModuleToLLVMIR(op);
+        }
+        return stealCStr(llvmir);
       },
       "module"_a);
 
@@ -94,23 +99,31 @@ PYBIND11_MODULE(_aie, m) {
       "generate_cdo",
       [](MlirOperation op, const std::string &workDirPath, bool bigendian,
          bool emitUnified, bool cdoDebug, bool aieSim, bool xaieDebug,
-         bool enableCores) {
+         bool enableCores, bool parallelColumns) {
         mlir::python::CollectDiagnosticsToStringScope scope(
             mlirOperationGetContext(op));
-        if (mlirLogicalResultIsFailure(aieTranslateToCDODirect(
-                op, {workDirPath.data(), workDirPath.size()}, bigendian,
-                emitUnified, cdoDebug, aieSim, xaieDebug, enableCores)))
+        MlirLogicalResult result;
+        {
+          py::gil_scoped_release release;
+          result = aieTranslateToCDODirect(
+              op, {workDirPath.data(), workDirPath.size()}, bigendian,
+              emitUnified, cdoDebug, aieSim, xaieDebug, enableCores,
+              parallelColumns);
+        }
+        if (mlirLogicalResultIsFailure(result))
           throw py::value_error("Failed to generate cdo because: " +
                                 scope.takeMessage());
       },
       "module"_a, "work_dir_path"_a, "bigendian"_a = false,
       "emit_unified"_a = false, "cdo_debug"_a = false, "aiesim"_a = false,
-      "xaie_debug"_a = false, "enable_cores"_a = true);
+      "xaie_debug"_a = false, "enable_cores"_a = true,
+      "parallel_columns"_a = false);
 
   m.def(
       "transaction_binary_to_mlir",
       [](MlirContext ctx, py::bytes bytes) {
-        std::string s = bytes;
+        // Decode straight out of the bytes object without copying it.
+        std::string_view s = bytes;
         MlirStringRef bin = {s.data(), s.size()};
         return aieTranslateBinaryToTxn(ctx, bin);
       },
@@ -148,13 +161,63 @@ PYBIND11_MODULE(_aie, m) {
       },
       "module"_a);
 
+  m.def(
+      "generate_ldscript",
+      [&stealCStr](MlirOperation op, int col, int row) {
+        MlirStringRef script;
+        {
+          py::gil_scoped_release release;
+          script = aieTranslateToLdScript(op, col, row);
+        }
+        return stealCStr(script);
+      },
+      "module"_a, "col"_a, "row"_a);
+
   m.def(
       "generate_bcf",
       [&stealCStr](MlirOperation op, int col, int row) {
-        return stealCStr(aieTranslateToBCF(op, col, row));
+        MlirStringRef script;
+        {
+          py::gil_scoped_release release;
+          script = aieTranslateToBCF(op, col, row);
+        }
+        return stealCStr(script);
       },
       "module"_a, "col"_a, "row"_a);
 
+  m.def(
+      "run_pass_pipeline",
+      [](MlirOperation op, const std::string &pipeline) {
+        // aiecc runs pipelines on several threads, each in its own context.
+        MlirLogicalResult result;
+        {
+          py::gil_scoped_release release;
+          result =
+              aieRunPassPipeline(op, {pipeline.data(), pipeline.length()});
+        }
+        if (mlirLogicalResultIsFailure(result))
+          throw std::runtime_error("failed to run pass pipeline: " + pipeline);
+      },
+      "module"_a, "pipeline"_a);
+
+  m.def(
+      "run_pass_pipeline_with_report",
+      [](MlirOperation op, const std::string &pipeline) {
+        // aiecc runs pipelines on several threads, each in its own context.
+        MlirStringRef report;
+        {
+          py::gil_scoped_release release;
+          report = aieRunPassPipelineWithReport(
+              op, {pipeline.data(), pipeline.length()});
+        }
+        if (!report.data)
+          throw std::runtime_error("failed to run pass pipeline: " + pipeline);
+        std::string s(report.data, report.length);
+        free((void *)report.data);
+        return s;
+      },
+      "module"_a, "pipeline"_a);
+
   m.def(
       "aie_llvm_link",
       [&stealCStr](std::vector<std::string> moduleStrs) {
@@ -167,6 +230,21 @@ PYBIND11_MODULE(_aie, m) {
       },
       "modules"_a);
 
+  m.def(
+      "aie_llvm_link_pruned",
+      [&stealCStr](std::vector<std::string> moduleStrs) {
+        std::vector<MlirStringRef> modules;
+        modules.reserve(moduleStrs.size());
+        for (auto &moduleStr : moduleStrs)
+          modules.push_back({moduleStr.data(), moduleStr.length()});
+
+        MlirStringRef report;
+        py::str linked = stealCStr(
+            aieLLVMLinkPruned(modules.data(), modules.size(), &report));
+        return py::make_tuple(linked, stealCStr(report));
+      },
+      "modules"_a);
+
   m.def("get_target_model",
         [](uint32_t d) -> PyAieTargetModel { return aieGetTargetModel(d); });
 
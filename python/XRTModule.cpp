@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "instr_binary.h"
+
 #include "xrt/xrt_bo.h"
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_kernel.h"
@@ -54,6 +56,21 @@ public:
     npuInstructions->sync(XCL_BO_SYNC_BO_TO_DEVICE);
   }
 
+  // Load a binary instruction file (e.g. insts.bin) by mapping it and copying
+  // the words straight into the instruction buffer object, without building
+  // an intermediate vector. The transaction header is checked first, see
+  // test_utils::check_instr_binary_header.
+  void loadNPUInstructionsFromFile(const std::string &instsPath,
+                                   int expectedDevGen) {
+    test_utils::instr_binary_view insts =
+        test_utils::map_instr_binary(instsPath, expectedDevGen);
+    npuInstructions =
+        std::make_unique<xrt::bo>(*device, insts.size_bytes(),
+                                  XCL_BO_FLAGS_CACHEABLE, kernel->group_id(0));
+    std::copy(insts.begin(), insts.end(), npuInstructions->map<uint32_t *>());
+    npuInstructions->sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  }
+
   template <typename ElementT>
   std::vector<py::memoryview>
   mmapBuffers(std::vector<std::vector<int>> shapes) {
@@ -146,6 +163,9 @@ PYBIND11_MODULE(_xrt, m) {
       .def(py::init<const std::string &, const std::string &, int>(),
            "xclbin_path"_a, "kernel_name"_a, "device_index"_a = 0)
       .def("load_npu_instructions", &PyXCLBin::loadNPUInstructions, "insts"_a)
+      .def("load_npu_instructions_from_file",
+           &PyXCLBin::loadNPUInstructionsFromFile, "insts_path"_a,
+           "expected_dev_gen"_a = -1)
       .def("sync_buffers_to_device", &PyXCLBin::syncBuffersToDevice)
       .def("sync_buffers_from_device", &PyXCLBin::syncBuffersFromDevice)
       .def("run", &PyXCLBin::run)
@@ -6,6 +6,7 @@
 # (c) Copyright 2021 Xilinx Inc.
 
 import argparse
+import os
 import sys
 
 from aie.compiler.aiecc.configure import *
@@ -164,6 +165,27 @@ def parse_args(args=None):
         action="store_true",
         help="Use dynamic object fifos for the for loops",
     )
+    parser.add_argument(
+        "--npu-cleanup",
+        dest="npu_cleanup",
+        default=False,
+        action="store_true",
+        help="Remove dead writes and redundant syncs from the lowered NPU instruction sequence",
+    )
+    parser.add_argument(
+        "--pipeline-core-loops",
+        dest="pipeline_core_loops",
+        default=False,
+        action="store_true",
+        help="Software pipeline the innermost vector loops of cores compiled with Peano (default is off)",
+    )
+    parser.add_argument(
+        "--prune-kernel-ir",
+        dest="prune_kernel_ir",
+        default=False,
+        action="store_true",
+        help="Link kernels that a core's link_with gives as LLVM IR (.ll) into the core's IR, removing the functions and tables it cannot reach, and write what was removed to core_<col>_<row>.prune.txt (Peano only)",
+    )
     parser.add_argument(
         "--aie-generate-airbin",
         dest="airbin",
@@ -185,6 +207,25 @@ def parse_args(args=None):
         action="store",
         help="Compile with max n-threads in the machine (default is 4).  An argument of zero corresponds to the maximum number of threads on the machine.",
     )
+    parser.add_argument(
+        "--cache-dir",
+        dest="cache_dir",
+        default=os.environ.get("AIECC_CACHE_DIR"),
+        help="Directory in which to cache core ELFs, keyed on their inputs, and reuse them across builds (default: $AIECC_CACHE_DIR, or no cache)",
+    )
+    parser.add_argument(
+        "--code-size-report",
+        dest="code_size_report",
+        default=None,
+        help="Write the program memory used by each core, and by each function in it, to this JSON file",
+    )
+    parser.add_argument(
+        "--incremental",
+        dest="incremental",
+        default=False,
+        action="store_true",
+        help="Reuse the core ELFs, CDO and xclbin of the previous build in the same work directory if only the runtime sequence changed, and only regenerate the NPU instructions",
+    )
     parser.add_argument(
         "--profile",
         dest="profiling",
@@ -192,6 +233,18 @@ def parse_args(args=None):
         action="store_true",
         help="Profile commands to find the most expensive executions.",
     )
+    parser.add_argument(
+        "--trace",
+        dest="trace_file",
+        default=None,
+        help="Write a Chrome trace (chrome://tracing, Perfetto) of the commands and in-process passes run, one track per worker",
+    )
+    parser.add_argument(
+        "--pass-report",
+        dest="pass_report",
+        default=None,
+        help="Time every pass of every MLIR pass pipeline run, including the per-core ones, count ops before and after each pipeline, and write the report to this file",
+    )
     parser.add_argument(
         "--unified",
         dest="unified",
@@ -250,6 +303,13 @@ def parse_args(args=None):
         const=True,
         help="Generate libxaie v2 for CDO",
     )
+    parser.add_argument(
+        "--cdo-parallel-columns",
+        dest="cdo_parallel_columns",
+        default=False,
+        action="store_true",
+        help="Load core ELFs for each column in parallel when generating CDO",
+    )
     parser.add_argument(
         "--aie-generate-txn",
         dest="txn",
@@ -9,17 +9,25 @@ aiecc - AIE compiler driver for MLIR tools
 """
 
 import asyncio
+import concurrent.futures
+import contextlib
+import contextvars
+import copy
 import glob
+import hashlib
+import heapq
 import json
 import os
 import random
 import re
 import shutil
 import stat
+import struct
 import subprocess
 import sys
 import tempfile
 from textwrap import dedent
+import threading
 import time
 import uuid
 
@@ -32,9 +40,8 @@ import aie.compiler.aiecc.cl_arguments
 import aie.compiler.aiecc.configure
 from aie.dialects import aie as aiedialect
 from aie.ir import Context, Location, Module
-from aie.passmanager import PassManager
 
-INPUT_WITH_ADDRESSES_PIPELINE = lambda scheme, dynamic_objFifos, ctrl_pkt_overlay: (
+INPUT_WITH_ADDRESSES_PIPELINE = lambda scheme, dynamic_objFifos, ctrl_pkt_overlay, pipeline_core_loops=False: (
     Pipeline()
     .lower_affine()
     .add_pass("aie-canonicalize-device")
@@ -55,7 +62,12 @@ INPUT_WITH_ADDRESSES_PIPELINE = lambda scheme, dynamic_objFifos, ctrl_pkt_overla
             "aie-generate-column-control-overlay",
             route_shim_to_tile_ctrl=ctrl_pkt_overlay,
         )
-        .add_pass("aie-assign-buffer-addresses", alloc_scheme=scheme),
+        .add_pass("aie-assign-buffer-addresses", alloc_scheme=scheme)
+        + (
+            Pipeline().add_pass("aie-pipeline-core-loops")
+            if pipeline_core_loops
+            else Pipeline()
+        ),
     )
     .convert_scf_to_cf()
 )
@@ -97,14 +109,15 @@ CREATE_PATH_FINDER_FLOWS = Pipeline().Nested(
     "aie.device", Pipeline().add_pass("aie-create-pathfinder-flows")
 )
 
-DMA_TO_NPU = Pipeline().Nested(
+DMA_TO_NPU = lambda npu_cleanup=False: Pipeline().Nested(
     "aie.device",
     Pipeline()
     .add_pass("aie-materialize-bd-chains")
     .add_pass("aie-substitute-shim-dma-allocations")
     .add_pass("aie-assign-runtime-sequence-bd-ids")
     .add_pass("aie-dma-tasks-to-npu")
-    .add_pass("aie-dma-to-npu"),
+    .add_pass("aie-dma-to-npu")
+    + (Pipeline().add_pass("aie-npu-cleanup") if npu_cleanup else Pipeline()),
 )
 
 
@@ -319,6 +332,185 @@ async def extract_input_files(file_core_bcf):
     return " ".join(re.findall(r"^_include _file (.*)", core_bcf, re.MULTILINE))
 
 
+def linked_input_files(link_script):
+    """Object files pulled in by a generated ld.script or BCF."""
+    matches = re.findall(
+        r"^INPUT\((.*)\)|^_include _file (.*)", link_script, re.MULTILINE
+    )
+    return [ldscript or bcf for ldscript, bcf in matches]
+
+
+# Bump when the inputs to the core ELF cache key change.
+CORE_CACHE_VERSION = "1"
+
+
+def core_cache_key(parts, files):
+    """Hash the strings in 'parts' and the contents of 'files' into a key."""
+    h = hashlib.sha256()
+    for part in [CORE_CACHE_VERSION, *parts]:
+        h.update(part.encode())
+        h.update(b"\0")
+    for f in files:
+        h.update(f.encode())
+        h.update(b"\0")
+        if os.path.exists(f):
+            with open(f, "rb") as fd:
+                h.update(hashlib.sha256(fd.read()).digest())
+    return h.hexdigest()
+
+
+def tool_version(tool, version_args=None):
+    """Identify the executable 'tool' for the core cache key: by what it prints
+    when run with 'version_args', or else by the path, size and modification
+    time of the file. Tools that cannot be found are identified by name."""
+    path = shutil.which(tool) or tool
+    if version_args is not None:
+        try:
+            ret = do_run([path, *version_args])
+            if ret.returncode == 0:
+                return ret.stdout
+        except OSError:
+            pass
+    try:
+        st = os.stat(path)
+    except OSError:
+        return f"{tool} (not found)"
+    return f"{os.path.realpath(path)} {st.st_size} {st.st_mtime_ns}"
+
+
+# Size of a core's program memory, in bytes.
+PROGRAM_MEMORY_SIZE = 0x4000
+
+# Flags and types from the ELF specification used by elf_code_size.
+SHF_EXECINSTR = 0x4
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+
+def elf_code_size(path):
+    """Return the total size of the executable sections of an ELF object or
+    executable, and the size of each function defined in them."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError(f"{path} is not an ELF file")
+    is64 = data[4] == 2
+    endian = "<" if data[5] == 1 else ">"
+    if is64:
+        (shoff,) = struct.unpack_from(endian + "Q", data, 0x28)
+        shentsize, shnum = struct.unpack_from(endian + "HH", data, 0x3A)
+        shdr, sym = endian + "IIQQQQIIQQ", endian + "IBBHQQ"
+    else:
+        (shoff,) = struct.unpack_from(endian + "I", data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + "HH", data, 0x2E)
+        shdr, sym = endian + "IIIIIIIIII", endian + "IIIBBH"
+    # (name, type, flags, addr, offset, size, link, info, addralign, entsize)
+    sections = [
+        struct.unpack_from(shdr, data, shoff + i * shentsize) for i in range(shnum)
+    ]
+
+    def executable(index):
+        return index < len(sections) and sections[index][2] & SHF_EXECINSTR
+
+    text = sum(sh[5] for i, sh in enumerate(sections) if executable(i))
+    functions = dict()
+    for sh in sections:
+        if sh[1] != SHT_SYMTAB:
+            continue
+        strtab = sections[sh[6]][4]
+        for offset in range(sh[4], sh[4] + sh[5], struct.calcsize(sym)):
+            if is64:
+                name, info, _, shndx, _, size = struct.unpack_from(sym, data, offset)
+            else:
+                name, _, size, info, _, shndx = struct.unpack_from(sym, data, offset)
+            if info & 0xF != STT_FUNC or size == 0 or not executable(shndx):
+                continue
+            start = strtab + name
+            name = data[start : data.index(b"\0", start)].decode()
+            functions[name] = functions.get(name, 0) + size
+    return text, functions
+
+
+# Options that affect neither the device configuration nor the core ELFs, so
+# changing them does not invalidate an --incremental build.
+INCREMENTAL_IGNORED_OPTS = {
+    "execute",
+    "code_size_report",
+    "filename",
+    "incremental",
+    "insts_name",
+    "npu",
+    "nthreads",
+    "only_npu",
+    "pass_report",
+    "profiling",
+    "progress",
+    "trace_file",
+    "verbose",
+}
+
+
+def device_fingerprint(mlir_module_str, opts):
+    """Hash what the device configuration and core ELFs are built from: the
+    design with its runtime sequences removed, the objects its cores link with
+    and the compile options."""
+    with Context(), Location.unknown():
+        module = Module.parse(mlir_module_str)
+        for seq in find_ops(
+            module.operation,
+            lambda o: o.operation.name == "aiex.runtime_sequence",
+        ):
+            seq.operation.erase()
+        device_ir = str(module)
+    options = [
+        f"{k}={v!r}"
+        for k, v in sorted(vars(opts).items())
+        if k not in INCREMENTAL_IGNORED_OPTS
+    ]
+    link_with = re.findall(r'link_with\s*=\s*"([^"]*)"', device_ir)
+    return core_cache_key([device_ir, *options], sorted(set(link_with)))
+
+
+def canonicalize_core_ir(ir, core):
+    """Give the symbols that differ between otherwise identical cores fixed names.
+
+    The core's main function and the external globals standing in for the
+    buffers it uses are renamed in the lowered LLVM dialect 'ir'. Buffers are
+    numbered in order of first use, and declarations of buffers the core does
+    not use are dropped. Returns the new IR and the linker flags that bind
+    this core's own symbols to the new names.
+    """
+    col, row, _ = core
+    decl = re.compile(
+        r"^[ \t]*llvm\.mlir\.global external @([\w$.]+)(?![\w$.]).*\n?", re.M
+    )
+    decls = {m.group(1): m.group(0) for m in decl.finditer(ir)}
+    first_decl = decl.search(ir)
+    decl_pos = first_decl.start() if first_decl else 0
+    body = decl.sub("", ir)
+
+    used = []
+    for m in re.finditer(r"@([\w$.]+)(?![\w$.])", body):
+        if m.group(1) in decls and m.group(1) not in used:
+            used.append(m.group(1))
+    # Put back the declarations of the used buffers, in order of first use.
+    ir = body[:decl_pos] + "".join(decls[n] for n in used) + body[decl_pos:]
+
+    defsyms = []
+    main = f"core_{col}_{row}"
+    pattern = re.compile(rf"@{re.escape(main)}(?![\w$.])")
+    if pattern.search(ir):
+        # Defined by the object, referenced by the linker script.
+        defsyms.append(f"-Wl,--defsym={main}=__aie_core_main")
+        ir = pattern.sub("@__aie_core_main", ir)
+    for i, name in enumerate(used):
+        # Referenced by the object, defined by the linker script.
+        canonical = f"__aie_core_buf_{i}"
+        defsyms.append(f"-Wl,--defsym={canonical}={name}")
+        ir = re.sub(rf"@{re.escape(name)}(?![\w$.])", "@" + canonical, ir)
+    return ir, defsyms
+
+
 def do_run(command, verbose=False):
     if verbose:
         print(" ".join(command))
@@ -327,14 +519,28 @@ def do_run(command, verbose=False):
     return ret
 
 
-def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
+def run_pipeline(op, pass_pipeline, report=None):
+    """Run pass_pipeline on op. If report is a list, the per-pass timing and op
+    count report of the run is appended to it. Otherwise the pipeline runs
+    without instrumentation.
+
+    The pipeline runs without holding the GIL, so pipelines on other threads,
+    in other contexts, run at the same time."""
+    if report is None:
+        aiedialect.run_pass_pipeline(op, pass_pipeline)
+    else:
+        report.append(aiedialect.run_pass_pipeline_with_report(op, pass_pipeline))
+
+
+def run_passes(
+    pass_pipeline, mlir_module_str, outputfile=None, verbose=False, report=None
+):
     if verbose:
         print("Running:", pass_pipeline)
     with Context() as ctx, Location.unknown():
         module = Module.parse(mlir_module_str)
-        pm = PassManager.parse(pass_pipeline)
         try:
-            pm.run(module.operation)
+            run_pipeline(module.operation, pass_pipeline, report)
         except Exception as e:
             print("Error running pass pipeline: ", pass_pipeline, e)
             raise e
@@ -345,11 +551,122 @@ def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
     return mlir_module_str
 
 
+def run_passes_on_file(
+    pass_pipeline, inputfile, outputfile, verbose=False, report=None
+):
+    with open(inputfile, "r") as f:
+        run_passes(pass_pipeline, f.read(), outputfile, verbose, report)
+
+
+def parse_pass_report(report):
+    """Split a run_pass_pipeline_with_report report into a list of (pass,
+    seconds) and a list of (op name, count before, count after)."""
+    passes, ops = [], []
+    for line in report.splitlines():
+        fields = line.split("\t")
+        if fields[0] == "pass":
+            passes.append((fields[1], float(fields[2])))
+        elif fields[0] == "op":
+            ops.append((fields[1], int(fields[2]), int(fields[3])))
+    return passes, ops
+
+
+# Core the current asyncio task compiles, attached to the trace spans it emits.
+trace_core = contextvars.ContextVar("trace_core", default=None)
+
+
 def corefile(dirname, core, ext):
     col, row, _ = core
     return os.path.join(dirname, f"core_{col}_{row}.{ext}")
 
 
+# MLIR context of each core worker thread, and its parse of the input. A
+# context must not be used by two threads at once, so each worker has its own.
+core_worker = threading.local()
+
+
+def core_worker_context():
+    if not hasattr(core_worker, "ctx"):
+        core_worker.ctx = Context()
+        # The cores themselves are compiled in parallel.
+        core_worker.ctx.enable_multithreading(False)
+    return core_worker.ctx
+
+
+def core_worker_module(input_file):
+    """Return this thread's parse of input_file."""
+    if getattr(core_worker, "input_file", None) != input_file:
+        with core_worker_context(), Location.unknown():
+            with open(input_file, "r") as f:
+                core_worker.module = Module.parse(f.read())
+        core_worker.input_file = input_file
+    return core_worker.module
+
+
+def lower_core_to_llvm(input_file, core, file_opt_core, report=None):
+    """Lower one core of input_file to the LLVM dialect.
+
+    The lowering runs on a clone, so the cores a worker thread compiles share
+    its single parse of input_file.
+    """
+    col, row, _ = core
+    input_module = core_worker_module(input_file)
+    with core_worker_context(), Location.unknown():
+        pass_pipeline = AIE_LOWER_TO_LLVM(col, row).materialize(module=True)
+        lowered = input_module.operation.clone()
+        try:
+            run_pipeline(lowered.operation, pass_pipeline, report)
+            with open(file_opt_core, "w") as f:
+                f.write(str(lowered))
+        finally:
+            lowered.operation.erase()
+
+
+def translate_core_to_llvmir(file_opt_core, file_core_llvmir):
+    with core_worker_context(), Location.unknown():
+        with open(file_opt_core, "r") as f:
+            module = Module.parse(f.read())
+        llvmir = aiedialect.translate_mlir_to_llvmir(module.operation)
+    with open(file_core_llvmir, "w") as f:
+        f.write(llvmir)
+
+
+def link_kernel_ir_pruned(core_llvmir, kernels, linked_llvmir, report_file):
+    """Link the LLVM IR files 'kernels' into the core's LLVM IR, removing the
+    functions and globals the core cannot reach. What was removed is written
+    to report_file and returned."""
+    modules = []
+    for path in [core_llvmir, *kernels]:
+        with open(path, "r") as f:
+            modules.append(f.read())
+    linked, report = aiedialect.aie_llvm_link_pruned(modules)
+    with open(linked_llvmir, "w") as f:
+        f.write(linked)
+    with open(report_file, "w") as f:
+        f.write(report)
+    return report
+
+
+def generate_core_link_script(input_file, core, bcf, outputfile):
+    col, row, _ = core
+    input_module = core_worker_module(input_file)
+    if bcf:
+        script = aiedialect.generate_bcf(input_module.operation, col, row)
+    else:
+        script = aiedialect.generate_ldscript(input_module.operation, col, row)
+    with open(outputfile, "w") as f:
+        f.write(script)
+
+
+def generate_cdo_from_file(input_file, work_dir, parallel_columns):
+    with Context(), Location.unknown():
+        with open(input_file, "r") as f:
+            module = Module.parse(f.read())
+        aiedialect.generate_cdo(
+            module.operation, work_dir, parallel_columns=parallel_columns
+        )
+
+
 def aie_target_defines(aie_target):
     if aie_target == "AIE2":
         return ["-D__AIEARCH__=20"]
@@ -384,10 +701,14 @@ def downgrade_ir_for_chess(llvmir_chesslinked):
 
 
 class FlowRunner:
-    def __init__(self, mlir_module_str, opts, tmpdirname):
+    def __init__(self, mlir_module_str, opts, tmpdirname, elf_dir="."):
         self.mlir_module_str = mlir_module_str
         self.opts = opts
         self.tmpdirname = tmpdirname
+        # Where core ELFs are written; the CDO and txn flows pick them up here.
+        self.elf_dir = elf_dir
+        # Worker limit, shared by the runners of a multi-device module.
+        self.limit = None
         self.runtimes = dict()
         self.progress_bar = None
         self.maxtasks = 5
@@ -395,10 +716,260 @@ class FlowRunner:
         self.peano_clang_path = os.path.join(opts.peano_install_dir, "bin", "clang")
         self.peano_opt_path = os.path.join(opts.peano_install_dir, "bin", "opt")
         self.peano_llc_path = os.path.join(opts.peano_install_dir, "bin", "llc")
+        self.toolchain_version = None
+        # Canonical core IR hash -> future for the object compiled from it.
+        self.core_objects = dict()
+        # The threads that in-process steps, such as the per-core lowering,
+        # run on.
+        self.core_pool = None
+        # Chrome trace events, and the worker tracks free to put spans on.
+        self.trace_events = []
+        self.trace_start = time.time()
+        self.trace_free_slots = []
+        self.trace_num_slots = 0
+        # (label, report list) for each pass pipeline run, for --pass-report.
+        self.pass_reports = []
+        # (col, row) -> (code size, {function: size}) of each linked core.
+        self.code_sizes = dict()
 
     def prepend_tmp(self, x):
         return os.path.join(self.tmpdirname, x)
 
+    def core_elf(self, core):
+        _, _, elf_file = core
+        if elf_file:
+            return os.path.join(self.elf_dir, elf_file)
+        return corefile(self.elf_dir, core, "elf")
+
+    def get_toolchain_version(self):
+        if self.toolchain_version is None:
+            tools = []
+            # xchesscc compiles with --xchesscc and links with --xbridge. It has
+            # no version option, so its executable identifies it.
+            if self.opts.xchesscc or self.opts.xbridge:
+                xchesscc = "xchesscc"
+                if self.opts.aietools_path:
+                    xchesscc = os.path.join(self.opts.aietools_path, "bin", xchesscc)
+                tools.append(tool_version(xchesscc))
+            # Peano does the rest.
+            if not (self.opts.xchesscc and self.opts.xbridge):
+                tools.append(tool_version(self.peano_clang_path, ["--version"]))
+            self.toolchain_version = "\n".join(tools)
+        return self.toolchain_version
+
+    async def get_core_cache_key(
+        self, core, aie_target, core_input, link_script, link_args
+    ):
+        # Everything the core ELF is built from: the core's lowered IR (or the
+        # shared object in unified mode), its linker script and the objects
+        # it pulls in, the toolchain and the flags.
+        link_script_str = await read_file_async(link_script)
+        parts = [
+            aie_target,
+            str(core[0:2]),
+            self.get_toolchain_version(),
+            " ".join(link_args),
+            str((self.opts.xchesscc, self.opts.xbridge, self.opts.unified)),
+            link_script_str,
+        ]
+        files = [core_input, *linked_input_files(link_script_str)]
+        return core_cache_key(parts, files)
+
+    def restore_cached_elf(self, key, file_core_elf):
+        cached = os.path.join(self.opts.cache_dir, key + ".elf")
+        if not os.path.exists(cached):
+            return False
+        shutil.copyfile(cached, file_core_elf)
+        if self.opts.verbose:
+            print(f"Reusing cached {cached} for {file_core_elf}")
+        return True
+
+    def store_cached_elf(self, key, file_core_elf):
+        if not os.path.exists(file_core_elf):
+            return
+        os.makedirs(self.opts.cache_dir, exist_ok=True)
+        cached = os.path.join(self.opts.cache_dir, key + ".elf")
+        # Copy then rename, so that concurrent builds never see a partial file.
+        partial = f"{cached}.{uuid.uuid4().hex}.tmp"
+        shutil.copyfile(file_core_elf, partial)
+        os.replace(partial, cached)
+
+    def incremental_outputs(self, cores):
+        """Build products an --incremental build reuses when only the runtime
+        sequence changed."""
+        outputs = []
+        if self.opts.link:
+            outputs += [self.core_elf(core) for core in cores]
+        if self.opts.cdo:
+            outputs += [
+                self.prepend_tmp(f"aie_cdo_{part}.bin")
+                for part in ["elfs", "init", "enable"]
+            ]
+        if self.opts.xcl:
+            outputs.append(self.opts.xclbin_name)
+        if self.opts.txn:
+            outputs.append(self.prepend_tmp("txn.mlir"))
+        if self.opts.ctrlpkt:
+            outputs.append(self.prepend_tmp("ctrlpkt.mlir"))
+        # The state outlives the working directory aiecc was started in.
+        return [os.path.abspath(f) for f in outputs]
+
+    def can_reuse_build(self, fingerprint):
+        try:
+            with open(self.prepend_tmp("incremental.json")) as f:
+                state = json.load(f)
+        except (OSError, ValueError):
+            return False
+        return state.get("device") == fingerprint and all(
+            os.path.exists(f) for f in state.get("outputs", [])
+        )
+
+    def save_incremental_state(self, fingerprint, cores):
+        with open(self.prepend_tmp("incremental.json"), "w") as f:
+            json.dump(
+                {"device": fingerprint, "outputs": self.incremental_outputs(cores)},
+                f,
+                indent=2,
+            )
+
+    def check_code_size(self, core, path, linked):
+        """Exit with the largest functions listed if the code in 'path' does
+        not fit in a core's program memory. 'linked' is set for the final
+        ELF, whose sizes are kept for --code-size-report. An object that is
+        not linked still has the sections the linker would garbage collect,
+        so it only gets a warning."""
+        text, functions = elf_code_size(path)
+        if linked:
+            self.code_sizes[core[0:2]] = (text, functions)
+        if text <= PROGRAM_MEMORY_SIZE:
+            return
+        if not linked:
+            print(
+                f"warning: core {core[0:2]} object has {text} bytes of code but "
+                f"only {PROGRAM_MEMORY_SIZE} bytes of program memory are "
+                f"available. Unused sections of {path} may still be dropped "
+                "when it is linked.",
+                file=sys.stderr,
+            )
+            return
+        print(
+            f"error: core {core[0:2]} needs {text} bytes of program memory but "
+            f"only {PROGRAM_MEMORY_SIZE} are available. Largest functions in "
+            f"{path}:",
+            file=sys.stderr,
+        )
+        largest = sorted(functions.items(), key=lambda item: item[1], reverse=True)
+        for name, size in largest[:10]:
+            print(f"{size:10d}  {name}", file=sys.stderr)
+        print(
+            "Loops unrolled over objectFifo elements and inlined kernels are the "
+            "usual causes; reduce the unrolling or move kernels out of line.",
+            file=sys.stderr,
+        )
+        sys.exit(1)
+
+    def dumpcodesizes(self, report_file):
+        cores = dict()
+        for (col, row), (text, functions) in sorted(self.code_sizes.items()):
+            cores[f"core_{col}_{row}"] = {
+                "size": text,
+                "functions": dict(
+                    sorted(functions.items(), key=lambda item: item[1], reverse=True)
+                ),
+            }
+        with open(report_file, "w") as f:
+            json.dump({"budget": PROGRAM_MEMORY_SIZE, "cores": cores}, f, indent=2)
+
+    def pass_report(self, label):
+        """Return the list a pass pipeline run should append its report to,
+        or None if no pass report was requested."""
+        if not self.opts.pass_report:
+            return None
+        report = []
+        self.pass_reports.append((label, report))
+        return report
+
+    def dumppassreport(self, report_file):
+        totals = dict()
+        sections = []
+        for label, report in self.pass_reports:
+            # Pipelines skipped by -n or that failed have no report.
+            if not report:
+                continue
+            passes, ops = parse_pass_report(report[0])
+            lines = [f"{label}:", f"{'seconds':>10}  pass"]
+            for name, seconds in passes:
+                lines.append(f"{seconds:10.4f}  {name}")
+                total = totals.setdefault(name, [0.0, 0])
+                total[0] += seconds
+                total[1] += 1
+            lines.append(f"{'before':>10} {'after':>8}  op")
+            for name, before, after in ops:
+                lines.append(f"{before:10d} {after:8d}  {name}")
+            sections.append("\n".join(lines))
+
+        lines = ["All pipelines:", f"{'seconds':>10} {'runs':>6}  pass"]
+        for name, (seconds, runs) in sorted(
+            totals.items(), key=lambda item: item[1][0], reverse=True
+        ):
+            lines.append(f"{seconds:10.4f} {runs:6d}  {name}")
+        with open(report_file, "w") as f:
+            f.write("\n\n".join(["\n".join(lines)] + sections) + "\n")
+
+    @contextlib.contextmanager
+    def trace_span(self, name, **args):
+        """Record the enclosed work as a span on the lowest free worker track."""
+        if self.trace_free_slots:
+            slot = heapq.heappop(self.trace_free_slots)
+        else:
+            slot = self.trace_num_slots
+            self.trace_num_slots += 1
+        core = trace_core.get()
+        if core is not None:
+            args["col"], args["row"] = core
+        start = time.time()
+        try:
+            yield
+        finally:
+            end = time.time()
+            heapq.heappush(self.trace_free_slots, slot)
+            self.trace_events.append(
+                {
+                    "name": name,
+                    "ph": "X",
+                    "pid": 0,
+                    "tid": slot,
+                    "ts": (start - self.trace_start) * 1e6,
+                    "dur": (end - start) * 1e6,
+                    "args": args,
+                }
+            )
+
+    def dumptrace(self, trace_file):
+        events = [
+            {
+                "name": "process_name",
+                "ph": "M",
+                "pid": 0,
+                "args": {"name": f"aiecc -j {self.opts.nthreads}"},
+            }
+        ]
+        for slot in range(self.trace_num_slots):
+            events.append(
+                {
+                    "name": "thread_name",
+                    "ph": "M",
+                    "pid": 0,
+                    "tid": slot,
+                    "args": {"name": f"worker {slot}"},
+                }
+            )
+        with open(trace_file, "w") as f:
+            json.dump(
+                {"traceEvents": events + self.trace_events, "displayTimeUnit": "ms"},
+                f,
+            )
+
     async def do_call(self, task, command, force=False):
         if self.stopall:
             return
@@ -410,8 +981,9 @@ class FlowRunner:
         if self.opts.verbose:
             print(commandstr)
         if self.opts.execute or force:
-            proc = await asyncio.create_subprocess_exec(*command)
-            await proc.wait()
+            with self.trace_span(os.path.basename(command[0]), command=commandstr):
+                proc = await asyncio.create_subprocess_exec(*command)
+                await proc.wait()
             ret = proc.returncode
         else:
             ret = 0
@@ -430,6 +1002,69 @@ class FlowRunner:
             print("Error encountered while running: " + commandstr, file=sys.stderr)
             sys.exit(ret)
 
+    async def do_in_process(self, task, description, fn, *args):
+        """Run fn(*args) on the core worker threads, accounted like do_call."""
+        if self.stopall:
+            return
+
+        if task:
+            self.progress_bar.update(task, advance=0, command=description[0:30])
+        start = time.time()
+        if self.opts.verbose:
+            print(description)
+        ret = 0
+        result = None
+        if self.opts.execute:
+            loop = asyncio.get_running_loop()
+            try:
+                with self.trace_span(description):
+                    result = await loop.run_in_executor(self.core_pool, fn, *args)
+            except Exception as e:
+                print(e, file=sys.stderr)
+                ret = 1
+        end = time.time()
+        if self.opts.verbose:
+            print(f"Done in {end - start:.3f} sec: {description}")
+        self.runtimes[description] = end - start
+        if task:
+            self.progress_bar.update(task, advance=1, command="")
+            self.maxtasks = max(self.progress_bar._tasks[task].completed, self.maxtasks)
+            self.progress_bar._tasks[task].total = self.maxtasks
+
+        if ret != 0:
+            if task:
+                self.progress_bar._tasks[task].description = "[red] Error"
+            print("Error encountered while running: " + description, file=sys.stderr)
+            sys.exit(ret)
+        return result
+
+    async def prune_kernel_ir(self, task, core, file_core_llvmir, file_core_ldscript):
+        """With --prune-kernel-ir, link the kernels the core's ld.script pulls in
+        as LLVM IR into the core's IR instead, keeping only what the core
+        reaches. Returns the IR file to compile."""
+        if not self.opts.prune_kernel_ir or not self.opts.execute:
+            return file_core_llvmir
+        link_script = await read_file_async(file_core_ldscript)
+        kernels = [f for f in linked_input_files(link_script) if f.endswith(".ll")]
+        if not kernels:
+            return file_core_llvmir
+        file_linked = corefile(self.tmpdirname, core, "linked.ll")
+        report = await self.do_in_process(
+            task,
+            "prune kernels for core (%d, %d)" % core[0:2],
+            link_kernel_ir_pruned,
+            file_core_llvmir,
+            kernels,
+            file_linked,
+            corefile(self.tmpdirname, core, "prune.txt"),
+        )
+        if self.opts.verbose and report:
+            print(report, end="")
+        # The kernels are now part of the core's object.
+        link_script = re.sub(r"^INPUT\(.*\.ll\)\n", "", link_script, flags=re.M)
+        await write_file_async(link_script, file_core_ldscript)
+        return file_linked
+
     # In order to run xchesscc on modern ll code, we need a bunch of hacks.
     async def chesshack(self, task, llvmir, aie_target):
         llvmir_chesshack = llvmir + "chesshack.ll"
@@ -481,6 +1116,7 @@ class FlowRunner:
         aie_peano_target,
         file_with_addresses,
     ):
+        trace_core.set(core[0:2])
         async with self.limit:
             if self.stopall:
                 return
@@ -505,27 +1141,75 @@ class FlowRunner:
                 task = None
 
             # fmt: off
-            corecol, corerow, elf_file = core
+            _, _, elf_file = core
             if not opts.unified:
-                file_core = corefile(self.tmpdirname, core, "mlir")
-                await self.do_call(task, ["aie-opt", "--aie-localize-locks", "--aie-normalize-address-spaces", "--aie-standard-lowering=tilecol=%d tilerow=%d" % core[0:2], "--aiex-standard-lowering", file_with_addresses, "-o", file_core])
                 file_opt_core = corefile(self.tmpdirname, core, "opt.mlir")
-                await self.do_call(task, ["aie-opt", f"--pass-pipeline={LOWER_TO_LLVM_PIPELINE}", file_core, "-o", file_opt_core])
+                await self.do_in_process(task, "lower core (%d, %d) to llvm" % core[0:2], lower_core_to_llvm, file_with_addresses, core, file_opt_core, self.pass_report("core (%d, %d)" % core[0:2]))
+
+            # SPMD designs have many cores running the same code on different
+            # buffers. Such cores lower to the same IR up to symbol names, so
+            # the IR is compiled once with canonical names, and each core links
+            # the object with its own names bound to them.
+            group_key = None
+            # Kernels linked in by --prune-kernel-ir are not part of the IR
+            # the cores are grouped by.
+            dedup_cores = (
+                not opts.unified
+                and not self.opts.xbridge
+                and not self.opts.prune_kernel_ir
+                and opts.compile
+                and opts.link
+                and self.opts.execute
+            )
+            if dedup_cores:
+                ir = await read_file_async(file_opt_core)
+                ir, core_defsyms = canonicalize_core_ir(ir, core)
+                file_opt_core = corefile(self.tmpdirname, core, "canonical.mlir")
+                await write_file_async(ir, file_opt_core)
+                clang_link_args += core_defsyms
+                group_key = hashlib.sha256(ir.encode()).hexdigest()
             if self.opts.xbridge:
                 file_core_bcf = corefile(self.tmpdirname, core, "bcf")
-                await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-bcf", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_bcf])
+                await self.do_in_process(task, "generate bcf for core (%d, %d)" % core[0:2], generate_core_link_script, file_with_addresses, core, True, file_core_bcf)
             else:
                 file_core_ldscript = corefile(self.tmpdirname, core, "ld.script")
-                await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-ldscript", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_ldscript])
-            if not self.opts.unified:
+                await self.do_in_process(task, "generate ldscript for core (%d, %d)" % core[0:2], generate_core_link_script, file_with_addresses, core, False, file_core_ldscript)
+
+            file_core_elf = self.core_elf(core)
+
+            cache_key = None
+            cached = False
+            if self.opts.cache_dir and opts.compile and opts.link and self.opts.execute:
+                cache_key = await self.get_core_cache_key(
+                    core,
+                    aie_target,
+                    self.unified_file_core_obj if opts.unified else file_opt_core,
+                    file_core_bcf if self.opts.xbridge else file_core_ldscript,
+                    clang_link_args,
+                )
+                cached = self.restore_cached_elf(cache_key, file_core_elf)
+
+            shared_obj = None
+            leader = False
+            if group_key and not cached:
+                if group_key in self.core_objects:
+                    shared_obj = await self.core_objects[group_key]
+                    if self.opts.verbose:
+                        print(f"Reusing {shared_obj} for core {core[0:2]}")
+                else:
+                    loop = asyncio.get_running_loop()
+                    self.core_objects[group_key] = loop.create_future()
+                    leader = True
+
+            if not self.opts.unified and not cached and not shared_obj:
                 file_core_llvmir = corefile(self.tmpdirname, core, "ll")
-                await self.do_call(task, ["aie-translate", "--mlir-to-llvmir", file_opt_core, "-o", file_core_llvmir])
+                await self.do_in_process(task, "translate core (%d, %d) to llvm ir" % core[0:2], translate_core_to_llvmir, file_opt_core, file_core_llvmir)
                 file_core_obj = corefile(self.tmpdirname, core, "o")
 
-            file_core_elf = elf_file if elf_file else corefile(".", core, "elf")
-
-            if opts.compile and opts.xchesscc:
-                if not opts.unified:
+            if cached:
+                pass
+            elif opts.compile and opts.xchesscc:
+                if not opts.unified and not shared_obj:
                     file_core_llvmir_chesslinked = await self.chesshack(task, file_core_llvmir, aie_target)
                     if self.opts.link and self.opts.xbridge:
                         link_with_obj = await extract_input_files(file_core_bcf)
@@ -534,7 +1218,7 @@ class FlowRunner:
                         await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_core_llvmir_chesslinked, "-o", file_core_obj])
                         await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
                 else:
-                    file_core_obj = self.unified_file_core_obj
+                    file_core_obj = shared_obj or self.unified_file_core_obj
                     if opts.link and opts.xbridge:
                         link_with_obj = await extract_input_files(file_core_bcf)
                         await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
@@ -542,12 +1226,18 @@ class FlowRunner:
                         await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
 
             elif opts.compile:
-                if not opts.unified:
+                if not opts.unified and not shared_obj:
+                    if not opts.xbridge:
+                        file_core_llvmir = await self.prune_kernel_ir(task, core, file_core_llvmir, file_core_ldscript)
                     file_core_llvmir_stripped = corefile(self.tmpdirname, core, "stripped.ll")
                     await self.do_call(task, [self.peano_opt_path, "--passes=default<O2>,strip", "-S", file_core_llvmir, "-o", file_core_llvmir_stripped])
                     await self.do_call(task, [self.peano_llc_path, file_core_llvmir_stripped, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", file_core_obj])
+                    # Only the linked ELF is checked against the limit, after
+                    # --gc-sections; without linking, warn on the object.
+                    if not opts.link and self.opts.execute and not self.stopall:
+                        self.check_code_size(core, file_core_obj, linked=False)
                 else:
-                    file_core_obj = self.unified_file_core_obj
+                    file_core_obj = shared_obj or self.unified_file_core_obj
 
                 if opts.link and opts.xbridge:
                     link_with_obj = await extract_input_files(file_core_bcf)
@@ -555,79 +1245,113 @@ class FlowRunner:
                 elif opts.link:
                     await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
 
-            self.progress_bar.update(self.progress_bar.task_completed, advance=1)
+            if opts.compile and opts.link and self.opts.execute and not self.stopall:
+                self.check_code_size(core, file_core_elf, linked=True)
+            if leader:
+                self.core_objects[group_key].set_result(file_core_obj)
+            if cache_key and not cached and not self.stopall:
+                self.store_cached_elf(cache_key, file_core_elf)
+
+            self.progress_bar.update(self.task_completed, advance=1)
             if task:
                 self.progress_bar.update(task, advance=0, visible=False)
             # fmt: on
 
+    async def process_npu_insts(self, task, file_with_addresses):
+        generated_insts_mlir = self.prepend_tmp("generated_npu_insts.mlir")
+        await self.do_in_process(
+            task,
+            "lower dma to npu",
+            run_passes_on_file,
+            DMA_TO_NPU(self.opts.npu_cleanup).materialize(module=True),
+            file_with_addresses,
+            generated_insts_mlir,
+            self.opts.verbose,
+            self.pass_report("generated_npu_insts"),
+        )
+        await self.do_call(
+            task,
+            [
+                "aie-translate",
+                "--aie-npu-instgen",
+                generated_insts_mlir,
+                "-o",
+                self.opts.insts_name,
+            ],
+        )
+
+    async def process_unified(self, task, aie_target, file_with_addresses):
+        # fmt: off
+        file_opt_with_addresses = self.prepend_tmp("input_opt_with_addresses.mlir")
+        await self.do_in_process(task, "lower cores to llvm", run_passes_on_file, AIE_LOWER_TO_LLVM().materialize(module=True), file_with_addresses, file_opt_with_addresses, self.opts.verbose, self.pass_report("input_opt_with_addresses"))
+
+        file_llvmir = self.prepend_tmp("input.ll")
+        await self.do_call(task, ["aie-translate", "--mlir-to-llvmir", file_opt_with_addresses, "-o", file_llvmir])
+
+        self.unified_file_core_obj = self.prepend_tmp("input.o")
+        if opts.compile and opts.xchesscc:
+            file_llvmir_hacked = await self.chesshack(task, file_llvmir, aie_target)
+            await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_llvmir_hacked, "-o", self.unified_file_core_obj])
+        elif opts.compile:
+            file_llvmir_opt = self.prepend_tmp("input.opt.ll")
+            await self.do_call(task, [self.peano_opt_path, "--passes=default<O2>", "-inline-threshold=10", "-S", file_llvmir, "-o", file_llvmir_opt])
+            await self.do_call(task, [self.peano_llc_path, file_llvmir_opt, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", self.unified_file_core_obj])
+        # fmt: on
+
+    def copy_elfs_to_tmpdir(self):
+        for elf in glob.glob(os.path.join(self.elf_dir, "*.elf")):
+            try:
+                shutil.copy(elf, self.tmpdirname)
+            except shutil.SameFileError:
+                pass
+        for elf_map in glob.glob(os.path.join(self.elf_dir, "*.elf.map")):
+            try:
+                shutil.copy(elf_map, self.tmpdirname)
+            except shutil.SameFileError:
+                pass
+
+    # The steps below run their blocking work on the worker threads, so that
+    # the event loop keeps driving the other steps meanwhile.
     async def process_cdo(self):
-        from aie.dialects.aie import generate_cdo
-
-        with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
-                try:
-                    shutil.copy(elf, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            for elf_map in glob.glob("*.elf.map"):
-                try:
-                    shutil.copy(elf_map, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            input_physical = Module.parse(
-                await read_file_async(self.prepend_tmp("input_physical.mlir"))
-            )
-            generate_cdo(input_physical.operation, self.tmpdirname)
+        await asyncio.to_thread(self.copy_elfs_to_tmpdir)
+        await self.do_in_process(
+            None,
+            "generate_cdo",
+            generate_cdo_from_file,
+            self.prepend_tmp("input_physical.mlir"),
+            self.tmpdirname,
+            self.opts.cdo_parallel_columns,
+        )
 
     async def process_txn(self):
-
-        with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
-                try:
-                    shutil.copy(elf, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            for elf_map in glob.glob("*.elf.map"):
-                try:
-                    shutil.copy(elf_map, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            input_physical = await read_file_async(
-                self.prepend_tmp("input_physical.mlir")
-            )
-            run_passes(
-                "builtin.module(aie.device(convert-aie-to-transaction{elf-dir="
-                + self.tmpdirname
-                + "}))",
-                input_physical,
-                self.prepend_tmp("txn.mlir"),
-                self.opts.verbose,
-            )
+        await asyncio.to_thread(self.copy_elfs_to_tmpdir)
+        await self.do_in_process(
+            None,
+            "convert-aie-to-transaction",
+            run_passes_on_file,
+            "builtin.module(aie.device(convert-aie-to-transaction{elf-dir="
+            + self.tmpdirname
+            + "}))",
+            self.prepend_tmp("input_physical.mlir"),
+            self.prepend_tmp("txn.mlir"),
+            self.opts.verbose,
+            self.pass_report("txn"),
+        )
 
     async def process_ctrlpkt(self):
-
-        with Context(), Location.unknown():
-            for elf in glob.glob("*.elf"):
-                try:
-                    shutil.copy(elf, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            for elf_map in glob.glob("*.elf.map"):
-                try:
-                    shutil.copy(elf_map, self.tmpdirname)
-                except shutil.SameFileError:
-                    pass
-            input_physical = await read_file_async(
-                self.prepend_tmp("input_physical.mlir")
-            )
-            run_passes(
-                "builtin.module(aie.device(convert-aie-to-control-packets{elf-dir="
-                + self.tmpdirname
-                + "}))",
-                input_physical,
-                self.prepend_tmp("ctrlpkt.mlir"),
-                self.opts.verbose,
-            )
+        await asyncio.to_thread(self.copy_elfs_to_tmpdir)
+        await self.do_in_process(
+            None,
+            "convert-aie-to-control-packets",
+            run_passes_on_file,
+            "builtin.module(aie.device(convert-aie-to-control-packets{elf-dir="
+            + self.tmpdirname
+            + "},aie-pack-control-packets))",
+            self.prepend_tmp("input_physical.mlir"),
+            self.prepend_tmp("ctrlpkt.mlir"),
+            self.opts.verbose,
+            self.pass_report("ctrlpkt"),
+        )
 
     async def process_xclbin_gen(self):
         if opts.progress:
@@ -686,10 +1410,25 @@ class FlowRunner:
         await self.do_call(task, ["xclbinutil"] + flag +
                                  ["--add-kernel", self.prepend_tmp("kernels.json"),
                                   "--add-replace-section", "AIE_PARTITION:JSON:" + self.prepend_tmp("aie_partition.json"),
-                                  "--force", "--quiet", "--output", opts.xclbin_name])
+                                  "--force", "--quiet", "--output", self.opts.xclbin_name])
         # fmt: on
 
-    async def process_host_cgen(self, aie_target, file_with_addresses):
+    async def process_physical(self, task, file_with_addresses):
+        # Route the design; the routed netlist feeds host codegen, simulation
+        # and the CDO/transaction/control packet generation.
+        async with self.limit:
+            await self.do_in_process(
+                task,
+                "create pathfinder flows",
+                run_passes_on_file,
+                CREATE_PATH_FINDER_FLOWS.materialize(module=True),
+                file_with_addresses,
+                self.prepend_tmp("input_physical.mlir"),
+                self.opts.verbose,
+                self.pass_report("input_physical"),
+            )
+
+    async def process_host_cgen(self, aie_target):
         async with self.limit:
             if self.stopall:
                 return
@@ -703,16 +1442,6 @@ class FlowRunner:
 
             # Generate the included host interface
             file_physical = self.prepend_tmp("input_physical.mlir")
-            await self.do_call(
-                task,
-                [
-                    "aie-opt",
-                    "--aie-create-pathfinder-flows",
-                    file_with_addresses,
-                    "-o",
-                    file_physical,
-                ],
-            )
 
             if opts.airbin:
                 file_airbin = self.prepend_tmp("air.bin")
@@ -847,7 +1576,7 @@ class FlowRunner:
             if len(opts.host_args) > 0:
                 await self.do_call(task, cmd + opts.host_args)
 
-            self.progress_bar.update(self.progress_bar.task_completed, advance=1)
+            self.progress_bar.update(self.task_completed, advance=1)
             if task:
                 self.progress_bar.update(task, advance=0, visible=False)
 
@@ -1044,39 +1773,41 @@ class FlowRunner:
         print("Simulation generated...")
         print("To run simulation: " + sim_script)
 
-    async def run_flow(self):
-        nworkers = int(opts.nthreads)
-        if nworkers == 0:
-            nworkers = os.cpu_count()
-
-        self.limit = asyncio.Semaphore(nworkers)
-        with progress.Progress(
-            *progress.Progress.get_default_columns(),
-            progress.TimeElapsedColumn(),
-            progress.MofNCompleteColumn(),
-            progress.TextColumn("{task.fields[command]}"),
-            redirect_stdout=False,
-            redirect_stderr=False,
-        ) as progress_bar:
+    async def run_flow(self, progress_bar=None):
+        nworkers = num_workers()
+        if self.limit is None:
+            self.limit = asyncio.Semaphore(nworkers)
+        if progress_bar is None:
+            progress_context = make_progress()
+        else:
+            progress_context = contextlib.nullcontext(progress_bar)
+        with progress_context as progress_bar:
             self.progress_bar = progress_bar
-            progress_bar.task = progress_bar.add_task(
+            mlir_task = progress_bar.add_task(
                 "[green] MLIR compilation:", total=1, command="1 Worker"
             )
 
             file_with_addresses = self.prepend_tmp("input_with_addresses.mlir")
 
+            # xchesscc pipelines loops on its own; with Peano they can be
+            # rotated ahead of time on request.
             pass_pipeline = INPUT_WITH_ADDRESSES_PIPELINE(
-                opts.alloc_scheme, opts.dynamic_objFifos, opts.ctrl_pkt_overlay
+                opts.alloc_scheme,
+                opts.dynamic_objFifos,
+                opts.ctrl_pkt_overlay,
+                opts.pipeline_core_loops and not opts.xchesscc,
             ).materialize(module=True)
 
-            run_passes(
-                pass_pipeline,
-                self.mlir_module_str,
-                file_with_addresses,
-                self.opts.verbose,
-            )
+            with self.trace_span("input_with_addresses pipeline"):
+                input_with_addresses = run_passes(
+                    pass_pipeline,
+                    self.mlir_module_str,
+                    file_with_addresses,
+                    self.opts.verbose,
+                    self.pass_report("input_with_addresses"),
+                )
 
-            cores = generate_cores_list(await read_file_async(file_with_addresses))
+            cores = generate_cores_list(input_with_addresses)
             t = do_run(
                 [
                     "aie-translate",
@@ -1094,87 +1825,113 @@ class FlowRunner:
                 exit(-3)
             aie_peano_target = aie_target.lower() + "-none-elf"
 
+            # Pass pipelines and other in-process steps run on these threads.
+            self.core_pool = concurrent.futures.ThreadPoolExecutor(nworkers)
+
+            # With --incremental, a design whose device configuration is
+            # unchanged since the last build only needs its runtime sequence
+            # lowered again; the ELFs, CDO and xclbin are reused. Host code is
+            # built from sources this does not track, so it always rebuilds.
+            fingerprint = None
+            if self.opts.incremental and self.opts.execute and not self.opts.host_args:
+                fingerprint = device_fingerprint(self.mlir_module_str, self.opts)
+                if self.can_reuse_build(fingerprint):
+                    if self.opts.verbose:
+                        print("Device configuration unchanged, reusing previous build")
+                    if self.opts.npu:
+                        await self.process_npu_insts(
+                            mlir_task, file_with_addresses
+                        )
+                    self.core_pool.shutdown()
+                    return
+
+            # Each step is started as soon as the steps whose outputs it reads
+            # have finished, so independent chains (NPU instructions, host
+            # code, simulation, per-core compilation) overlap.
+            steps = []
+
+            def schedule(deps, fn, *args):
+                async def run():
+                    await asyncio.gather(*deps)
+                    return await fn(*args)
+
+                step = asyncio.ensure_future(run())
+                steps.append(step)
+                return step
+
             # Optionally generate insts.txt for NPU instruction stream
             if opts.npu or opts.only_npu:
-                generated_insts_mlir = self.prepend_tmp("generated_npu_insts.mlir")
-                await self.do_call(
-                    progress_bar.task,
-                    [
-                        "aie-opt",
-                        f"--pass-pipeline={DMA_TO_NPU}",
-                        file_with_addresses,
-                        "-o",
-                        generated_insts_mlir,
-                    ],
-                )
-                await self.do_call(
-                    progress_bar.task,
-                    [
-                        "aie-translate",
-                        "--aie-npu-instgen",
-                        generated_insts_mlir,
-                        "-o",
-                        opts.insts_name,
-                    ],
+                npu_insts = schedule(
+                    [], self.process_npu_insts, mlir_task, file_with_addresses
                 )
                 if opts.only_npu:
+                    await npu_insts
+                    self.core_pool.shutdown()
                     return
 
-            # fmt: off
+            unified = []
             if opts.unified:
-                file_opt_with_addresses = self.prepend_tmp("input_opt_with_addresses.mlir")
-                await self.do_call(progress_bar.task, ["aie-opt", f"--pass-pipeline={AIE_LOWER_TO_LLVM()}", file_with_addresses, "-o", file_opt_with_addresses])
-
-                file_llvmir = self.prepend_tmp("input.ll")
-                await self.do_call(progress_bar.task, ["aie-translate", "--mlir-to-llvmir", file_opt_with_addresses, "-o", file_llvmir])
-
-                self.unified_file_core_obj = self.prepend_tmp("input.o")
-                if opts.compile and opts.xchesscc:
-                    file_llvmir_hacked = await self.chesshack(progress_bar.task, file_llvmir, aie_target)
-                    await self.do_call(progress_bar.task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "+Wclang,-xir", "-f", file_llvmir_hacked, "-o", self.unified_file_core_obj])
-                elif opts.compile:
-                    file_llvmir_opt = self.prepend_tmp("input.opt.ll")
-                    await self.do_call(progress_bar.task, [self.peano_opt_path, "--passes=default<O2>", "-inline-threshold=10", "-S", file_llvmir, "-o", file_llvmir_opt])
-                    await self.do_call(progress_bar.task, [self.peano_llc_path, file_llvmir_opt, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", self.unified_file_core_obj])
-            # fmt: on
+                unified.append(
+                    schedule(
+                        [],
+                        self.process_unified,
+                        mlir_task,
+                        aie_target,
+                        file_with_addresses,
+                    )
+                )
 
-            progress_bar.update(progress_bar.task, advance=0, visible=False)
-            progress_bar.task_completed = progress_bar.add_task(
+            self.task_completed = progress_bar.add_task(
                 "[green] AIE Compilation:",
                 total=len(cores) + 1,
                 command="%d Workers" % nworkers,
             )
 
-            processes = [self.process_host_cgen(aie_target, file_with_addresses)]
-            await asyncio.gather(
-                *processes
-            )  # ensure that process_host_cgen finishes before running gen_sim
-            processes = []
+            physical = schedule(
+                [], self.process_physical, mlir_task, file_with_addresses
+            )
+            host_cgen = schedule([physical], self.process_host_cgen, aie_target)
             if opts.aiesim:
-                processes.append(self.gen_sim(progress_bar.task, aie_target))
-            for core in cores:
-                processes.append(
-                    self.process_core(
-                        core,
-                        aie_target,
-                        aie_peano_target,
-                        file_with_addresses,
-                    )
+                # The simulation wrapper includes the generated aie_inc.cpp.
+                schedule([host_cgen], self.gen_sim, mlir_task, aie_target)
+
+            # The per-core lowering and link script generation run in-process,
+            # on clones of one parse of the input per worker thread, rather
+            # than in aie-opt and aie-translate subprocesses that would each
+            # re-parse it.
+            elfs = [
+                schedule(
+                    unified,
+                    self.process_core,
+                    core,
+                    aie_target,
+                    aie_peano_target,
+                    file_with_addresses,
                 )
-            await asyncio.gather(*processes)
+                for core in cores
+            ]
 
             # Must have elfs, before we build the final binary assembly
+            cdo = []
             if opts.cdo and opts.execute:
-                await self.process_cdo()
+                cdo.append(schedule([physical, *elfs], self.process_cdo))
 
             if opts.cdo or opts.xcl:
-                await self.process_xclbin_gen()
+                schedule([physical, *elfs, *cdo], self.process_xclbin_gen)
 
             if opts.txn and opts.execute:
-                await self.process_txn()
+                schedule([physical, *elfs], self.process_txn)
 
             if opts.ctrlpkt and opts.execute:
-                await self.process_ctrlpkt()
+                schedule([physical, *elfs], self.process_ctrlpkt)
+
+            try:
+                await asyncio.gather(*steps)
+            finally:
+                self.core_pool.shutdown()
+            if fingerprint and not self.stopall:
+                self.save_incremental_state(fingerprint, cores)
+            progress_bar.update(mlir_task, advance=0, visible=False)
 
     def dumpprofile(self):
         sortedruntimes = sorted(
@@ -1186,6 +1943,66 @@ class FlowRunner:
                 print(f"{s1:.4f} sec: {s0}")
 
 
+def num_workers():
+    nworkers = int(opts.nthreads)
+    if nworkers == 0:
+        nworkers = os.cpu_count()
+    return nworkers
+
+
+def make_progress():
+    return progress.Progress(
+        *progress.Progress.get_default_columns(),
+        progress.TimeElapsedColumn(),
+        progress.MofNCompleteColumn(),
+        progress.TextColumn("{task.fields[command]}"),
+        redirect_stdout=False,
+        redirect_stderr=False,
+    )
+
+
+def split_devices(mlir_module_str):
+    """Return one module per aie.device in the input, each keeping the other
+    top-level ops of the input."""
+
+    def devices(module_op):
+        return [
+            op
+            for op in module_op.operation.regions[0].blocks[0]
+            if isinstance(op.operation.opview, aiedialect.DeviceOp)
+        ]
+
+    with Context(), Location.unknown():
+        module = Module.parse(mlir_module_str)
+        num_devices = len(devices(module))
+        if num_devices < 2:
+            return [mlir_module_str]
+        device_modules = []
+        for i in range(num_devices):
+            device_module = module.operation.clone()
+            for j, device in enumerate(devices(device_module)):
+                if j != i:
+                    device.operation.erase()
+            device_modules.append(str(device_module))
+            device_module.operation.erase()
+        return device_modules
+
+
+def device_output_name(path, device_name):
+    """Insert the device name before the extension of an output file name."""
+    root, ext = os.path.splitext(path)
+    return f"{root}.{device_name}{ext}"
+
+
+async def run_flows(runners):
+    # All devices share the worker limit and the progress display.
+    limit = asyncio.Semaphore(num_workers())
+    with make_progress() as progress_bar:
+        for runner in runners:
+            runner.limit = limit
+        await asyncio.gather(*(runner.run_flow(progress_bar) for runner in runners))
+
+
 def run(mlir_module, args=None):
     global opts
     if args is not None:
@@ -1250,11 +2067,49 @@ def run(mlir_module, args=None):
     if opts.verbose:
         print("created temporary directory", tmpdirname)
 
-    runner = FlowRunner(str(mlir_module), opts, tmpdirname)
-    asyncio.run(runner.run_flow())
-
-    if opts.profiling:
-        runner.dumpprofile()
+    # The backends handle one device at a time. A module with several devices
+    # is split, and each device is compiled by its own runner, concurrently,
+    # into a subdirectory named after it; its outputs get the name too.
+    device_modules = split_devices(str(mlir_module))
+    if len(device_modules) == 1:
+        runners = [FlowRunner(device_modules[0], opts, tmpdirname)]
+        asyncio.run(runners[0].run_flow())
+    else:
+        runners = []
+        for i, device_module in enumerate(device_modules):
+            device_name = f"device{i}"
+            device_opts = copy.copy(opts)
+            for output in [
+                "insts_name",
+                "xclbin_name",
+                "trace_file",
+                "pass_report",
+                "code_size_report",
+            ]:
+                if getattr(opts, output):
+                    setattr(
+                        device_opts,
+                        output,
+                        device_output_name(getattr(opts, output), device_name),
+                    )
+            device_tmpdirname = os.path.join(tmpdirname, device_name)
+            os.makedirs(device_tmpdirname, exist_ok=True)
+            runners.append(
+                FlowRunner(
+                    device_module, device_opts, device_tmpdirname, device_tmpdirname
+                )
+            )
+        asyncio.run(run_flows(runners))
+
+    for runner in runners:
+        if opts.profiling:
+            runner.dumpprofile()
+        if runner.opts.trace_file:
+            runner.dumptrace(runner.opts.trace_file)
+        if runner.opts.pass_report:
+            runner.dumppassreport(runner.opts.pass_report)
+        if runner.opts.code_size_report:
+            runner.dumpcodesizes(runner.opts.code_size_report)
 
 
 def main():
@@ -29,12 +29,16 @@ from .._mlir_libs._aie import (
     ObjectFifoType,
     get_target_model,
     aie_llvm_link,
+    aie_llvm_link_pruned,
     generate_bcf,
     generate_cdo,
+    generate_ldscript,
     generate_xaie,
     generate_control_packets,
     npu_instgen,
     register_dialect,
+    run_pass_pipeline,
+    run_pass_pipeline_with_report,
     translate_aie_vec_to_cpp,
     translate_mlir_to_llvmir,
     transaction_binary_to_mlir,
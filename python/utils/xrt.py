@@ -6,6 +6,7 @@
 #
 # (c) Copyright 2024 Advanced Micro Devices, Inc.
 import copy
+import os
 import numpy as np
 import pyxrt as xrt
 
@@ -102,17 +103,65 @@ class AIE_Application_Error(Exception):
 insts_cache = {}
 
 
+def check_insts_binary_header(insts_v, expected_dev_gen=None):
+    """Check the transaction header at the start of a binary instruction file
+    given as a uint32 array, mirroring test_utils::check_instr_binary_header.
+
+    The header must be complete, the format version must be supported, the
+    size it records must match the size of the array and, if expected_dev_gen
+    is given, the device generation must match. Returns None if the header is
+    valid, the reason otherwise.
+    """
+    # The header alone is four words: version, geometry, op count, size.
+    if insts_v.size < 4:
+        return "file is truncated"
+    major = insts_v[0] & 0xFF
+    minor = (insts_v[0] >> 8) & 0xFF
+    dev_gen = (insts_v[0] >> 16) & 0xFF
+    if major != 1:
+        return f"unsupported instruction file version {major}.{minor}"
+    if insts_v[3] != insts_v.nbytes:
+        return f"header records {insts_v[3]} bytes but the file has {insts_v.nbytes}"
+    if expected_dev_gen is not None and dev_gen != expected_dev_gen:
+        return f"targets device generation {dev_gen}, expected {expected_dev_gen}"
+    return None
+
+
+def map_insts_binary(insts_path, expected_dev_gen=None):
+    """Map a binary instruction file (e.g. insts.bin) as a read-only uint32
+    array without reading or parsing it. The header is validated with
+    check_insts_binary_header.
+    """
+    # np.memmap cannot map empty files or partial words.
+    size = os.path.getsize(insts_path)
+    if size < 16 or size % 4:
+        raise AIE_Application_Error(f"{insts_path}: file is truncated")
+    insts_v = np.memmap(insts_path, dtype=np.uint32, mode="r")
+    error = check_insts_binary_header(insts_v, expected_dev_gen)
+    if error:
+        raise AIE_Application_Error(f"{insts_path}: {error}")
+    return insts_v
+
+
 def read_insts(insts_path):
     global insts_cache
-    if insts_path in insts_cache:
-        # Speed up things if we re-configure the array a lot: Don't re-parse
-        # the insts.txt each time
-        return insts_cache[insts_path]
-    with open(insts_path, "r") as f:
-        insts_text = f.readlines()
-        insts_text = [l for l in insts_text if l != ""]
-        insts_v = np.array([int(c, 16) for c in insts_text], dtype=np.uint32)
-        insts_cache[insts_path] = insts_v
+    # Speed up things if we re-configure the array a lot: Don't re-parse the
+    # instructions each time. The file may be rebuilt in the same process, so
+    # a cached entry is only reused while its modification time and size are
+    # unchanged.
+    st = os.stat(insts_path)
+    stamp = (st.st_mtime_ns, st.st_size)
+    cached = insts_cache.get(insts_path)
+    if cached and cached[0] == stamp:
+        return cached[1]
+    if insts_path.endswith(".bin"):
+        insts_v = map_insts_binary(insts_path)
+    else:
+        with open(insts_path, "r") as f:
+            insts_text = f.readlines()
+            insts_text = [l for l in insts_text if l != ""]
+            insts_v = np.array([int(c, 16) for c in insts_text], dtype=np.uint32)
+    insts_cache[insts_path] = (stamp, insts_v)
     return insts_v
 
 
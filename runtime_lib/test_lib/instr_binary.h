@@ -0,0 +1,144 @@
+//===- instr_binary.h -------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Header-only helpers to map and validate binary instruction files (e.g.
+// insts.bin). Shared by the host test utilities and the XRT Python bindings.
+
+#ifndef _INSTR_BINARY_H_
+#define _INSTR_BINARY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace test_utils {
+
+// Check the transaction header at the start of a binary instruction file of
+// 'size_bytes' bytes: the header must be complete, the format version must be
+// supported and the recorded size must match the file size. If
+// expected_dev_gen is not negative, the device generation must match too.
+// Returns an empty string if the header is valid, the reason otherwise.
+inline std::string check_instr_binary_header(const uint32_t *words,
+                                              size_t size_bytes,
+                                              int expected_dev_gen = -1) {
+  // The header alone is four words: version, geometry, op count, size.
+  if (size_bytes < 4 * sizeof(uint32_t) || size_bytes % sizeof(uint32_t))
+    return "file is truncated";
+  unsigned major = words[0] & 0xff;
+  unsigned minor = (words[0] >> 8) & 0xff;
+  int dev_gen = (words[0] >> 16) & 0xff;
+  if (major != 1)
+    return "unsupported instruction file version " + std::to_string(major) +
+           "." + std::to_string(minor);
+  if (words[3] != size_bytes)
+    return "header records " + std::to_string(words[3]) +
+           " bytes but the file has " + std::to_string(size_bytes);
+  if (expected_dev_gen >= 0 && dev_gen != expected_dev_gen)
+    return "targets device generation " + std::to_string(dev_gen) +
+           ", expected " + std::to_string(expected_dev_gen);
+  return "";
+}
+
+class instr_binary_view;
+
+// Map a binary instruction file and validate its header with
+// check_instr_binary_header. Throws std::runtime_error on failure.
+inline instr_binary_view map_instr_binary(const std::string &instr_path,
+                                          int expected_dev_gen = -1);
+
+// Read-only view of a binary instruction file mapped into memory. The words
+// are used in place: nothing is parsed or copied until they are written into
+// an instruction buffer object. The mapping is released when the view is
+// destroyed.
+class instr_binary_view {
+public:
+  instr_binary_view() = default;
+  instr_binary_view(const instr_binary_view &) = delete;
+  instr_binary_view &operator=(const instr_binary_view &) = delete;
+  instr_binary_view(instr_binary_view &&other) noexcept
+      : words(other.words), num_words(other.num_words) {
+    other.words = nullptr;
+    other.num_words = 0;
+  }
+  instr_binary_view &operator=(instr_binary_view &&other) noexcept {
+    std::swap(words, other.words);
+    std::swap(num_words, other.num_words);
+    return *this;
+  }
+  ~instr_binary_view() {
+    if (words)
+      munmap(const_cast<uint32_t *>(words), size_bytes());
+  }
+
+  const uint32_t *data() const { return words; }
+  // Number of 32-bit words in the file, including the header.
+  size_t size() const { return num_words; }
+  size_t size_bytes() const { return num_words * sizeof(uint32_t); }
+  const uint32_t *begin() const { return words; }
+  const uint32_t *end() const { return words + num_words; }
+
+  // Fields of the transaction header written by aie-translate.
+  uint8_t major_version() const { return words[0] & 0xff; }
+  uint8_t minor_version() const { return (words[0] >> 8) & 0xff; }
+  uint8_t dev_gen() const { return (words[0] >> 16) & 0xff; }
+  uint8_t num_rows() const { return (words[0] >> 24) & 0xff; }
+  uint8_t num_cols() const { return words[1] & 0xff; }
+  uint8_t num_mem_tile_rows() const { return (words[1] >> 8) & 0xff; }
+  uint32_t num_ops() const { return words[2]; }
+
+private:
+  friend instr_binary_view map_instr_binary(const std::string &instr_path,
+                                            int expected_dev_gen);
+  const uint32_t *words = nullptr;
+  size_t num_words = 0;
+};
+
+inline instr_binary_view map_instr_binary(const std::string &instr_path,
+                                          int expected_dev_gen) {
+  int fd = open(instr_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Unable to open instruction file " + instr_path);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("Unable to stat instruction file " + instr_path);
+  }
+  size_t size = st.st_size;
+  if (size < 4 * sizeof(uint32_t) || size % sizeof(uint32_t)) {
+    close(fd);
+    throw std::runtime_error("Instruction file " + instr_path +
+                             ": file is truncated");
+  }
+  void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    throw std::runtime_error("Unable to map instruction file " + instr_path);
+
+  instr_binary_view view;
+  view.words = static_cast<const uint32_t *>(p);
+  view.num_words = size / sizeof(uint32_t);
+
+  std::string error =
+      check_instr_binary_header(view.data(), size, expected_dev_gen);
+  if (!error.empty())
+    throw std::runtime_error("Instruction file " + instr_path + ": " + error);
+  return view;
+}
+
+} // namespace test_utils
+
+#endif // _INSTR_BINARY_H_
@@ -27,6 +27,8 @@
 #include <string>
 #include <vector>
 
+#include "instr_binary.h"
+
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_kernel.h"
 
@@ -44,6 +46,9 @@ void parse_options(int argc, const char *argv[], po::options_description &desc,
 std::vector<uint32_t> load_instr_sequence(std::string instr_path);
 std::vector<uint32_t> load_instr_binary(std::string instr_path);
 
+// Binary instruction files can also be mapped in place with
+// map_instr_binary from instr_binary.h, which validates their header.
+
 void init_xrt_load_kernel(xrt::device &device, xrt::kernel &kernel,
                           int verbosity, std::string xclbinFileName,
                           std::string kernelNameInXclbin);
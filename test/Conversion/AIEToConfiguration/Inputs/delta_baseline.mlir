@@ -0,0 +1,22 @@
+//===- delta_baseline.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Baseline design for convert_aie_to_transaction_delta.mlir.
+
+aie.device(npu1_1col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %tile_0_3 = aie.tile(0, 3)
+  %switchbox_0_2 = aie.switchbox(%tile_0_2) {
+    aie.connect<South : 0, North : 0>
+  }
+  %switchbox_0_3 = aie.switchbox(%tile_0_3) {
+    aie.connect<South : 0, DMA : 0>
+  }
+}
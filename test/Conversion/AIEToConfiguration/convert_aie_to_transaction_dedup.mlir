@@ -0,0 +1,58 @@
+//===- convert_aie_to_transaction_dedup.mlir -------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -split-input-file -convert-aie-to-transaction="optimize-writes=true" %s | FileCheck %s
+
+// The three connections enable the same slave port, which is written once.
+// The master port writes are sorted and batched into a single blockwrite.
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK-NEXT: memref.get_global
+// CHECK-NEXT: aiex.npu.blockwrite({{.*}}) {address = {{[0-9]+}} : ui32} : memref<3xi32>
+// CHECK-NEXT: aiex.npu.write32
+// CHECK-NEXT: }
+
+aie.device(npu1_1col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %switchbox_0_2 = aie.switchbox(%tile_0_2) {
+    aie.connect<South : 0, North : 2>
+    aie.connect<South : 0, North : 0>
+    aie.connect<South : 0, North : 1>
+  }
+}
+
+// -----
+
+// Writes are only sorted within a tile: tile (0, 3) is configured first and
+// stays first, although its registers are at higher addresses.
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK-NEXT: memref.get_global
+// CHECK-NEXT: aiex.npu.blockwrite({{.*}}) {address = 340{{[0-9]{4}}} : ui32} : memref<3xi32>
+// CHECK-NEXT: aiex.npu.write32 {address = 340{{[0-9]{4}}} : ui32
+// CHECK-NEXT: memref.get_global
+// CHECK-NEXT: aiex.npu.blockwrite({{.*}}) {address = 235{{[0-9]{4}}} : ui32} : memref<3xi32>
+// CHECK-NEXT: aiex.npu.write32 {address = 235{{[0-9]{4}}} : ui32
+// CHECK-NEXT: }
+
+aie.device(npu1_1col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %tile_0_3 = aie.tile(0, 3)
+  %switchbox_0_3 = aie.switchbox(%tile_0_3) {
+    aie.connect<South : 0, North : 2>
+    aie.connect<South : 0, North : 0>
+    aie.connect<South : 0, North : 1>
+  }
+  %switchbox_0_2 = aie.switchbox(%tile_0_2) {
+    aie.connect<South : 0, North : 2>
+    aie.connect<South : 0, North : 0>
+    aie.connect<South : 0, North : 1>
+  }
+}
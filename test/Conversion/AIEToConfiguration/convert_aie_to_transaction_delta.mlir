@@ -0,0 +1,40 @@
+//===- convert_aie_to_transaction_delta.mlir -------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -convert-aie-to-transaction="baseline=%S/Inputs/delta_baseline.mlir" %s | FileCheck %s
+// RUN: aie-opt -convert-aie-to-transaction="baseline=%s" %s | FileCheck %s --check-prefix=SAME
+
+// The switchbox of tile (0, 2) is unchanged and not written. The connection
+// in tile (0, 3) is no longer used, so its ports are cleared before the new
+// connection in tile (0, 4) is made.
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK-NOT: address = 235{{[0-9]+}}
+// CHECK-COUNT-2: aiex.npu.write32 {address = 340{{[0-9]+}} : ui32, value = 0 : ui32}
+// CHECK-NOT: address = 235{{[0-9]+}}
+// CHECK: address = 445{{[0-9]+}}
+// CHECK-NOT: address = 235{{[0-9]+}}
+// CHECK: }
+
+// Nothing needs to be written to reconfigure a design with itself.
+
+// SAME-LABEL: aiex.runtime_sequence @configure
+// SAME-NEXT: }
+
+aie.device(npu1_1col) {
+  %tile_0_2 = aie.tile(0, 2)
+  %tile_0_4 = aie.tile(0, 4)
+  %switchbox_0_2 = aie.switchbox(%tile_0_2) {
+    aie.connect<South : 0, North : 0>
+  }
+  %switchbox_0_4 = aie.switchbox(%tile_0_4) {
+    aie.connect<South : 0, DMA : 0>
+  }
+}
@@ -0,0 +1,41 @@
+//===- pack_ctrl_pkts.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-pack-control-packets %s | FileCheck %s
+
+// Stream switch writes to tiles (0, 2) and (0, 3) are collected up to the
+// lock write, and issued sorted per tile in packets of at most four words.
+// The overwritten word at 0x23F004 keeps its last value. The two lock writes
+// to consecutive addresses share a packet, but not across the npu.sync.
+
+// CHECK-LABEL: aiex.runtime_sequence @configure
+// CHECK-NEXT: aiex.control_packet {address = 2355200 : ui32, data = array<i32: 1, 5, 3, 4>, opcode = 0 : i32, stream_id = 0 : i32}
+// CHECK-NEXT: aiex.control_packet {address = 2355216 : ui32, data = array<i32: 6>, opcode = 0 : i32, stream_id = 0 : i32}
+// CHECK-NEXT: aiex.control_packet {address = 3403776 : ui32, data = array<i32: 7, 8>, opcode = 0 : i32, stream_id = 0 : i32}
+// CHECK-NEXT: aiex.control_packet {address = 2224128 : ui32, data = array<i32: 1, 2>, opcode = 0 : i32, stream_id = 0 : i32}
+// CHECK-NEXT: aiex.npu.sync
+// CHECK-NEXT: aiex.control_packet {address = 2224136 : ui32, data = array<i32: 3>, opcode = 0 : i32, stream_id = 0 : i32}
+// CHECK-NEXT: }
+module {
+  aie.device(npu1_1col) {
+    aiex.runtime_sequence @configure() {
+      aiex.control_packet {address = 3403776 : ui32, data = array<i32: 7>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 2355200 : ui32, data = array<i32: 1, 2>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 3403780 : ui32, data = array<i32: 8>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 2355208 : ui32, data = array<i32: 3>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 2355212 : ui32, data = array<i32: 4, 6>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 2355204 : ui32, data = array<i32: 5>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 2224128 : ui32, data = array<i32: 1>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.control_packet {address = 2224132 : ui32, data = array<i32: 2>, opcode = 0 : i32, stream_id = 0 : i32}
+      aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.control_packet {address = 2224136 : ui32, data = array<i32: 3>, opcode = 0 : i32, stream_id = 0 : i32}
+    }
+  }
+}
@@ -0,0 +1,82 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm -verify-diagnostics | FileCheck %s
+
+func.func @i8_bxor(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.bxor %arg0, %arg1 : vector<64xi8>, vector<64xi8>, vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// CHECK-LABEL: @i8_bxor
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<64xi8>
+// CHECK-NEXT: %[[LHS:.*]] = llvm.bitcast %[[ARG0]] : vector<64xi8> to vector<16xi32>
+// CHECK-NEXT: %[[RHS:.*]] = llvm.bitcast %[[ARG1]] : vector<64xi8> to vector<16xi32>
+// CHECK-NEXT: %[[XOR:.*]] = llvm.xor %[[LHS]], %[[RHS]] : vector<16xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[XOR]] : vector<16xi32> to vector<64xi8>
+// CHECK-NEXT: return %[[RES]] : vector<64xi8>
+
+// -----
+
+func.func @i32_bor_band(%arg0 : vector<16xi32>, %arg1 : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.bor %arg0, %arg1 : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  %1 = aievec.band %0, %arg1 : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  return %1 : vector<16xi32>
+}
+
+// CHECK-LABEL: @i32_bor_band
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xi32>
+// CHECK-NEXT: %[[OR:.*]] = llvm.or %[[ARG0]], %[[ARG1]] : vector<16xi32>
+// CHECK-NEXT: %[[AND:.*]] = llvm.and %[[OR]], %[[ARG1]] : vector<16xi32>
+// CHECK-NEXT: return %[[AND]] : vector<16xi32>
+
+// -----
+
+func.func @invalid_i16_bxor(%arg0 : vector<16xi16>, %arg1 : vector<16xi16>) -> vector<16xi16> {
+  // expected-warning @+2 {{aievec.bxor conversion with 'vector<16xi16>' result is not supported.}}
+  // expected-error @+1 {{failed to legalize operation 'aievec.bxor' that was explicitly marked illegal}}
+  %0 = aievec.bxor %arg0, %arg1 : vector<16xi16>, vector<16xi16>, vector<16xi16>
+  return %0 : vector<16xi16>
+}
+
+// -----
+
+func.func @i16_bneg(%arg0 : vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.bneg %arg0 : vector<32xi16>
+  return %0 : vector<32xi16>
+}
+
+// CHECK-LABEL: @i16_bneg
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>
+// CHECK-NEXT: %[[ONES:.*]] = llvm.mlir.constant(dense<-1> : vector<16xi32>) : vector<16xi32>
+// CHECK-NEXT: %[[SRC:.*]] = llvm.bitcast %[[ARG0]] : vector<32xi16> to vector<16xi32>
+// CHECK-NEXT: %[[XOR:.*]] = llvm.xor %[[SRC]], %[[ONES]] : vector<16xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[XOR]] : vector<16xi32> to vector<32xi16>
+// CHECK-NEXT: return %[[RES]] : vector<32xi16>
+
+// -----
+
+func.func @f32_neg(%arg0 : vector<16xf32>) -> vector<16xf32> {
+  %0 = aievec.neg %arg0 : vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// CHECK-LABEL: @f32_neg
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xf32>
+// CHECK-NEXT: %[[SIGN:.*]] = llvm.mlir.constant(dense<-2147483648> : vector<16xi32>) : vector<16xi32>
+// CHECK-NEXT: %[[SRC:.*]] = llvm.bitcast %[[ARG0]] : vector<16xf32> to vector<16xi32>
+// CHECK-NEXT: %[[XOR:.*]] = llvm.xor %[[SRC]], %[[SIGN]] : vector<16xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[XOR]] : vector<16xi32> to vector<16xf32>
+// CHECK-NEXT: return %[[RES]] : vector<16xf32>
+
+// -----
+
+func.func @i32_neg(%arg0 : vector<32xi32>) -> vector<32xi32> {
+  %0 = aievec.neg %arg0 : vector<32xi32>
+  return %0 : vector<32xi32>
+}
+
+// CHECK-LABEL: @i32_neg
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi32>
+// CHECK-NEXT: %[[ZERO:.*]] = llvm.mlir.constant(dense<0> : vector<32xi32>) : vector<32xi32>
+// CHECK-NEXT: %[[RES:.*]] = llvm.sub %[[ZERO]], %[[ARG0]] : vector<32xi32>
+// CHECK-NEXT: return %[[RES]] : vector<32xi32>
@@ -0,0 +1,87 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+func.func @i8_sgt_sel(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "sgt"} : vector<64xi8>, vector<64xi8>, ui64
+  %1 = aievec.sel %arg0, %arg1, %0 : vector<64xi8>, vector<64xi8>, ui64, vector<64xi8>
+  return %1 : vector<64xi8>
+}
+
+// CHECK-LABEL: @i8_sgt_sel
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<64xi8>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK-NEXT: %[[VMAX:.*]] = "xllvm.intr.aie2.vmax.lt8"(
+// CHECK-SAME: %[[ARG1]], %[[ARG0]], %[[SIGN]]) :
+// CHECK-SAME: (vector<64xi8>, vector<64xi8>, i32) -> !llvm.struct<(vector<64xi8>, vector<2xi32>)>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.extractvalue %[[VMAX]][1] : !llvm.struct<(vector<64xi8>, vector<2xi32>)>
+// CHECK-NEXT: %[[MASK64:.*]] = llvm.bitcast %[[MASK]] : vector<2xi32> to i64
+// CHECK-NEXT: %[[SEL:.*]] = llvm.bitcast %[[MASK64]] : i64 to vector<2xi32>
+// CHECK-NEXT: %[[RES:.*]] = "xllvm.intr.aie2.vsel8"(
+// CHECK-SAME: %[[ARG1]], %[[ARG0]], %[[SEL]]) :
+// CHECK-SAME: (vector<64xi8>, vector<64xi8>, vector<2xi32>) -> vector<64xi8>
+// CHECK-NEXT: return %[[RES]] : vector<64xi8>
+
+// -----
+
+func.func @i16_uge(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "uge"} : vector<32xi16>, vector<32xi16>, ui32
+  %1 = aievec.sel %arg0, %arg1, %0 : vector<32xi16>, vector<32xi16>, ui32, vector<32xi16>
+  return %1 : vector<32xi16>
+}
+
+// CHECK-LABEL: @i16_uge
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xi16>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK-NEXT: %[[VMIN:.*]] = "xllvm.intr.aie2.vmin.ge16"(
+// CHECK-SAME: %[[ARG0]], %[[ARG1]], %[[SIGN]]) :
+// CHECK-SAME: (vector<32xi16>, vector<32xi16>, i32) -> !llvm.struct<(vector<32xi16>, i32)>
+// CHECK-NEXT: %[[MASK:.*]] = llvm.extractvalue %[[VMIN]][1] : !llvm.struct<(vector<32xi16>, i32)>
+// CHECK-NEXT: %[[RES:.*]] = "xllvm.intr.aie2.vsel16"(
+// CHECK-SAME: %[[ARG1]], %[[ARG0]], %[[MASK]]) :
+// CHECK-SAME: (vector<32xi16>, vector<32xi16>, i32) -> vector<32xi16>
+// CHECK-NEXT: return %[[RES]] : vector<32xi16>
+
+// -----
+
+func.func @i32_eq(%arg0 : vector<16xi32>, %arg1 : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "eq"} : vector<16xi32>, vector<16xi32>, ui32
+  %1 = aievec.sel %arg0, %arg1, %0 : vector<16xi32>, vector<16xi32>, ui32, vector<16xi32>
+  return %1 : vector<16xi32>
+}
+
+// CHECK-LABEL: @i32_eq
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<16xi32>
+// CHECK: %[[VMIN0:.*]] = "xllvm.intr.aie2.vmin.ge32"(%[[ARG0]], %[[ARG1]],
+// CHECK: %[[MASK0:.*]] = llvm.extractvalue %[[VMIN0]][1]
+// CHECK: %[[VMIN1:.*]] = "xllvm.intr.aie2.vmin.ge32"(%[[ARG1]], %[[ARG0]],
+// CHECK: %[[MASK1:.*]] = llvm.extractvalue %[[VMIN1]][1]
+// CHECK-NEXT: %[[MASK:.*]] = llvm.and %[[MASK0]], %[[MASK1]] : i32
+// CHECK-NEXT: %[[RES:.*]] = "xllvm.intr.aie2.vsel32"(
+// CHECK-SAME: %[[ARG1]], %[[ARG0]], %[[MASK]]) :
+// CHECK-SAME: (vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+// CHECK-NEXT: return %[[RES]] : vector<16xi32>
+
+// -----
+
+func.func @bf16_ne(%arg0 : vector<32xbf16>, %arg1 : vector<32xbf16>) -> vector<32xbf16> {
+  %0 = aievec.cmp %arg0, %arg1 {pred = "ne"} : vector<32xbf16>, vector<32xbf16>, ui32
+  %1 = aievec.sel %arg0, %arg1, %0 : vector<32xbf16>, vector<32xbf16>, ui32, vector<32xbf16>
+  return %1 : vector<32xbf16>
+}
+
+// CHECK-LABEL: @bf16_ne
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xbf16>,
+// CHECK-SAME: %[[ARG1:.*]]: vector<32xbf16>
+// CHECK: %[[VMAX0:.*]] = "xllvm.intr.aie2.vmax.ltbf16"(%[[ARG0]], %[[ARG1]]) :
+// CHECK-SAME: (vector<32xbf16>, vector<32xbf16>) -> !llvm.struct<(vector<32xbf16>, i32)>
+// CHECK-NEXT: %[[MASK0:.*]] = llvm.extractvalue %[[VMAX0]][1]
+// CHECK-NEXT: %[[VMAX1:.*]] = "xllvm.intr.aie2.vmax.ltbf16"(%[[ARG1]], %[[ARG0]])
+// CHECK-NEXT: %[[MASK1:.*]] = llvm.extractvalue %[[VMAX1]][1]
+// CHECK-NEXT: %[[MASK:.*]] = llvm.or %[[MASK0]], %[[MASK1]] : i32
+// CHECK-NEXT: %[[RHS:.*]] = llvm.bitcast %[[ARG1]] : vector<32xbf16> to vector<32xi16>
+// CHECK-NEXT: %[[LHS:.*]] = llvm.bitcast %[[ARG0]] : vector<32xbf16> to vector<32xi16>
+// CHECK-NEXT: %[[SEL:.*]] = "xllvm.intr.aie2.vsel16"(%[[RHS]], %[[LHS]], %[[MASK]])
+// CHECK-NEXT: %[[RES:.*]] = llvm.bitcast %[[SEL]] : vector<32xi16> to vector<32xbf16>
+// CHECK-NEXT: return %[[RES]] : vector<32xbf16>
@@ -144,3 +144,27 @@ module {
     aie.shim_dma_allocation @toMem (S2MM, 0, 0)
   }
 }
+
+// -----
+
+// Devices are converted independently; each numbers its own BD data globals.
+// CHECK: aie.device
+// CHECK: memref.global "private" constant @blockwrite_data_0 : memref<8xi32>
+// CHECK: aie.device
+// CHECK: memref.global "private" constant @blockwrite_data_0 : memref<8xi32>
+module {
+  aie.device(npu1_1col) {
+    memref.global "public" @toMem : memref<16xi32>
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 16, 16][0, 0, 64, 1]) { metadata = @toMem, id = 1 : i64 } : memref<16xi32>
+    }
+    aie.shim_dma_allocation @toMem (S2MM, 0, 0)
+  }
+  aie.device(npu1_1col) {
+    memref.global "public" @toMem : memref<16xi32>
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      aiex.npu.dma_memcpy_nd (0, 0, %arg0[0, 0, 0, 0][1, 1, 16, 16][0, 0, 64, 1]) { metadata = @toMem, id = 1 : i64 } : memref<16xi32>
+    }
+    aie.shim_dma_allocation @toMem (S2MM, 0, 0)
+  }
+}
@@ -0,0 +1,103 @@
+//===- npu_cleanup.mlir ----------------------------------------*- MLIR -*-===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-npu-cleanup %s | FileCheck %s
+
+// Overwritten RTP writes and repeated values are dropped, a sync keeps the
+// write before it alive.
+
+// CHECK-LABEL: aiex.runtime_sequence @rtp
+// CHECK-NEXT: aiex.npu.write32 {address = 1540 : ui32, column = 2 : i32, row = 3 : i32, value = 7 : ui32}
+// CHECK-NEXT: aiex.npu.write32 {address = 1536 : ui32, column = 2 : i32, row = 3 : i32, value = 2 : ui32}
+// CHECK-NEXT: aiex.npu.sync
+// CHECK-NEXT: aiex.npu.write32 {address = 1536 : ui32, column = 2 : i32, row = 3 : i32, value = 3 : ui32}
+// CHECK-NEXT: }
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence @rtp() {
+      aiex.npu.write32 {address = 1536 : ui32, column = 2 : i32, row = 3 : i32, value = 1 : ui32}
+      aiex.npu.write32 {address = 1540 : ui32, column = 2 : i32, row = 3 : i32, value = 7 : ui32}
+      aiex.npu.write32 {address = 1536 : ui32, column = 2 : i32, row = 3 : i32, value = 2 : ui32}
+      aiex.npu.write32 {address = 1540 : ui32, column = 2 : i32, row = 3 : i32, value = 7 : ui32}
+      aiex.npu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.npu.write32 {address = 1536 : ui32, column = 2 : i32, row = 3 : i32, value = 3 : ui32}
+    }
+  }
+}
+
+// -----
+
+// Masked writes are folded into a known register value or merged with each
+// other; empty masks are dropped. Lock and queue writes act as barriers.
+
+// CHECK-LABEL: aiex.runtime_sequence @masks
+// CHECK-NEXT: aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 0 : i32, value = 4660 : ui32}
+// CHECK-NEXT: aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 65535 : ui32, row = 0 : i32, value = 4386 : ui32}
+// CHECK-NEXT: aiex.npu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+// CHECK-NEXT: aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 255 : ui32, row = 0 : i32, value = 3 : ui32}
+// CHECK-NEXT: }
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence @masks() {
+      aiex.npu.write32 {address = 118784 : ui32, column = 0 : i32, row = 0 : i32, value = 4096 : ui32}
+      aiex.npu.maskwrite32 {address = 118784 : ui32, column = 0 : i32, mask = 4095 : ui32, row = 0 : i32, value = 564 : ui32}
+      aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 255 : ui32, row = 0 : i32, value = 34 : ui32}
+      aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 65280 : ui32, row = 0 : i32, value = 4352 : ui32}
+      aiex.npu.maskwrite32 {address = 118792 : ui32, column = 0 : i32, mask = 0 : ui32, row = 0 : i32, value = 1 : ui32}
+      aiex.npu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+      aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 255 : ui32, row = 0 : i32, value = 3 : ui32}
+    }
+  }
+}
+
+// -----
+
+// Only syncs that wait on a channel whose tokens were all consumed already are
+// removed; the first sync may wait on a token issued elsewhere.
+
+// CHECK-LABEL: aiex.runtime_sequence @syncs
+// CHECK-NEXT: aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// CHECK-NEXT: aiex.npu.write32 {address = 119324 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483651 : ui32}
+// CHECK-NEXT: aiex.npu.write32 {address = 119324 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483652 : ui32}
+// CHECK-NEXT: aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// CHECK-NEXT: aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// CHECK-NEXT: }
+module {
+  aie.device(npu1_4col) {
+    aiex.runtime_sequence @syncs() {
+      aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.npu.write32 {address = 119324 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483651 : ui32}
+      aiex.npu.write32 {address = 119324 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483652 : ui32}
+      aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+      aiex.npu.sync {channel = 1 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+    }
+  }
+}
+
+// -----
+
+// A masked write is not folded into an earlier write across a block write
+// that covers the same word; the earlier write is dead instead.
+
+// CHECK-LABEL: aiex.runtime_sequence @mask_after_block
+// CHECK-NEXT: memref.get_global
+// CHECK-NEXT: aiex.npu.blockwrite
+// CHECK-NEXT: aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 255 : ui32, row = 0 : i32, value = 3 : ui32}
+// CHECK-NEXT: }
+module {
+  aie.device(npu1_4col) {
+    memref.global "private" constant @bd : memref<8xi32> = dense<[2, 0, 0, 0, 0, 0, 0, 0]>
+    aiex.runtime_sequence @mask_after_block() {
+      aiex.npu.write32 {address = 118788 : ui32, column = 0 : i32, row = 0 : i32, value = 5 : ui32}
+      %0 = memref.get_global @bd : memref<8xi32>
+      aiex.npu.blockwrite(%0) {address = 118784 : ui32, column = 0 : i32, row = 0 : i32} : memref<8xi32>
+      aiex.npu.maskwrite32 {address = 118788 : ui32, column = 0 : i32, mask = 255 : ui32, row = 0 : i32, value = 3 : ui32}
+    }
+  }
+}
@@ -0,0 +1,71 @@
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aie2" | FileCheck %s
+
+// CHECK-DAG: emitc.include <"vec_math.h">
+// CHECK-DAG: emitc.include <"lut_based_ops.h">
+
+// CHECK-LABEL: func @test_log
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<16xbf16>
+func.func @test_log(%a: vector<16xbf16>) -> vector<16xbf16> {
+  // CHECK: %[[OPQ:.*]] = builtin.unrealized_conversion_cast %[[A]] : vector<16xbf16> to !emitc.opaque<"v16bfloat16">
+  // CHECK: %[[CALL:.*]] = emitc.call_opaque "getLogBf16"(%[[OPQ]]) : (!emitc.opaque<"v16bfloat16">) -> !emitc.opaque<"v16bfloat16">
+  // CHECK: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[CALL]] : !emitc.opaque<"v16bfloat16"> to vector<16xbf16>
+  %0 = math.log %a : vector<16xbf16>
+  // CHECK: return %[[RES]] : vector<16xbf16>
+  return %0 : vector<16xbf16>
+}
+
+// CHECK-LABEL: func @test_log1p
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<32xbf16>
+func.func @test_log1p(%a: vector<32xbf16>) -> vector<32xbf16> {
+  // CHECK: %[[OPQ:.*]] = builtin.unrealized_conversion_cast %[[A]] : vector<32xbf16> to !emitc.opaque<"v32bfloat16">
+  // CHECK: %[[CALL:.*]] = emitc.call_opaque "getLog1pBf16"(%[[OPQ]]) : (!emitc.opaque<"v32bfloat16">) -> !emitc.opaque<"v32bfloat16">
+  // CHECK: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[CALL]] : !emitc.opaque<"v32bfloat16"> to vector<32xbf16>
+  %0 = math.log1p %a : vector<32xbf16>
+  // CHECK: return %[[RES]] : vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
+
+// CHECK-LABEL: func @test_gelu_erf
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<32xbf16>
+func.func @test_gelu_erf(%a: vector<32xbf16>) -> vector<32xbf16> {
+  %cst_rsqrt2 = arith.constant dense<7.070310e-01> : vector<32xbf16>
+  %cst_1 = arith.constant dense<1.000000e+00> : vector<32xbf16>
+  %cst_0_5 = arith.constant dense<5.000000e-01> : vector<32xbf16>
+  // CHECK-NOT: math.erf
+  // CHECK: %[[OPQ:.*]] = builtin.unrealized_conversion_cast %[[A]] : vector<32xbf16> to !emitc.opaque<"v32bfloat16">
+  // CHECK: %[[CALL:.*]] = emitc.call_opaque "getGeluErfBf16"(%[[OPQ]]) : (!emitc.opaque<"v32bfloat16">) -> !emitc.opaque<"v32bfloat16">
+  // CHECK: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[CALL]] : !emitc.opaque<"v32bfloat16"> to vector<32xbf16>
+  // CHECK-NOT: arith.mulf
+  %0 = arith.mulf %a, %cst_rsqrt2 : vector<32xbf16>
+  %1 = math.erf %0 : vector<32xbf16>
+  %2 = arith.addf %1, %cst_1 : vector<32xbf16>
+  %3 = arith.mulf %a, %2 : vector<32xbf16>
+  %4 = arith.mulf %3, %cst_0_5 : vector<32xbf16>
+  // CHECK: return %[[RES]] : vector<32xbf16>
+  return %4 : vector<32xbf16>
+}
+
+// CHECK-LABEL: func @test_gelu_tanh
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<16xbf16>
+func.func @test_gelu_tanh(%a: vector<16xbf16>) -> vector<16xbf16> {
+  %cst_c = arith.constant dense<4.467770e-02> : vector<16xbf16>
+  %cst_sqrt_2_over_pi = arith.constant dense<7.968750e-01> : vector<16xbf16>
+  %cst_1 = arith.constant dense<1.000000e+00> : vector<16xbf16>
+  %cst_0_5 = arith.constant dense<5.000000e-01> : vector<16xbf16>
+  // CHECK-NOT: math.tanh
+  // CHECK: %[[OPQ:.*]] = builtin.unrealized_conversion_cast %[[A]] : vector<16xbf16> to !emitc.opaque<"v16bfloat16">
+  // CHECK: %[[CALL:.*]] = emitc.call_opaque "getGeluTanhBf16"(%[[OPQ]]) : (!emitc.opaque<"v16bfloat16">) -> !emitc.opaque<"v16bfloat16">
+  // CHECK: %[[RES:.*]] = builtin.unrealized_conversion_cast %[[CALL]] : !emitc.opaque<"v16bfloat16"> to vector<16xbf16>
+  // CHECK-NOT: aievec.mul_elem
+  %0 = arith.mulf %a, %a : vector<16xbf16>
+  %1 = arith.mulf %0, %a : vector<16xbf16>
+  %2 = arith.mulf %cst_c, %1 : vector<16xbf16>
+  %3 = arith.addf %a, %2 : vector<16xbf16>
+  %4 = arith.mulf %cst_sqrt_2_over_pi, %3 : vector<16xbf16>
+  %5 = math.tanh %4 : vector<16xbf16>
+  %6 = arith.addf %5, %cst_1 : vector<16xbf16>
+  %7 = arith.mulf %cst_0_5, %a : vector<16xbf16>
+  %8 = arith.mulf %7, %6 : vector<16xbf16>
+  // CHECK: return %[[RES]] : vector<16xbf16>
+  return %8 : vector<16xbf16>
+}
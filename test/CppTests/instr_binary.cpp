@@ -0,0 +1,129 @@
+//===- instr_binary.cpp -----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "instr_binary.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace test_utils;
+
+// A temporary file that is removed when it goes out of scope.
+struct TempFile {
+  std::string path;
+
+  TempFile() {
+    char name[] = "instr_binary_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0)
+      throw std::runtime_error("Unable to create a temporary file");
+    close(fd);
+    path = name;
+  }
+  ~TempFile() { unlink(path.c_str()); }
+
+  void write(const void *data, size_t size) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f || fwrite(data, 1, size, f) != size)
+      throw std::runtime_error("Unable to write " + path);
+    fclose(f);
+  }
+  void write(const std::vector<uint32_t> &words) {
+    write(words.data(), words.size() * sizeof(uint32_t));
+  }
+};
+
+// Maps 'path' and returns the error, or an empty string if it succeeded.
+std::string mapError(const std::string &path, int expected_dev_gen = -1) {
+  try {
+    map_instr_binary(path, expected_dev_gen);
+  } catch (const std::runtime_error &e) {
+    return e.what();
+  }
+  return "";
+}
+
+void expectError(const std::string &path, const std::string &expected,
+                 int expected_dev_gen = -1) {
+  std::string error = mapError(path, expected_dev_gen);
+  if (error != "Instruction file " + path + ": " + expected)
+    throw std::runtime_error("Expected '" + expected + "', got '" + error +
+                             "'");
+}
+
+void test() {
+  TempFile file;
+
+  // Version 1.0 for device generation 3: 6 rows, 4 columns, 1 memory tile
+  // row, 1 op and 20 bytes.
+  const std::vector<uint32_t> good = {0x06030001, 0x0104, 1, 20, 0xcafe};
+  file.write(good);
+  {
+    instr_binary_view view = map_instr_binary(file.path, 3);
+    if (view.size() != good.size() || view.size_bytes() != 20)
+      throw std::runtime_error("Failed size of a valid file");
+    if (!std::equal(view.begin(), view.end(), good.begin()))
+      throw std::runtime_error("Failed contents of a valid file");
+    if (view.major_version() != 1 || view.minor_version() != 0 ||
+        view.dev_gen() != 3 || view.num_rows() != 6 || view.num_cols() != 4 ||
+        view.num_mem_tile_rows() != 1 || view.num_ops() != 1)
+      throw std::runtime_error("Failed header fields of a valid file");
+
+    // Moving transfers the mapping and leaves the source empty.
+    const uint32_t *data = view.data();
+    instr_binary_view moved(std::move(view));
+    if (moved.data() != data || moved.size() != good.size())
+      throw std::runtime_error("Failed move construction");
+    if (view.data() || view.size())
+      throw std::runtime_error("Failed to empty a moved-from view");
+
+    instr_binary_view assigned;
+    assigned = std::move(moved);
+    if (assigned.data() != data || assigned.size() != good.size())
+      throw std::runtime_error("Failed move assignment");
+    if (moved.data() || moved.size())
+      throw std::runtime_error("Failed to empty a moved-from view");
+    if (assigned.begin()[4] != 0xcafe)
+      throw std::runtime_error("Failed contents after a move");
+  }
+
+  expectError(file.path, "targets device generation 3, expected 4", 4);
+
+  // A header cut short, and a file that is not a whole number of words.
+  file.write({0x06030001, 0x0104});
+  expectError(file.path, "file is truncated");
+  const uint8_t partial[] = {0x01, 0x00, 0x03, 0x06, 0x04, 0x01, 0x00,
+                             0x00, 0x01, 0x00, 0x00, 0x00, 0x11};
+  file.write(partial, sizeof(partial));
+  expectError(file.path, "file is truncated");
+
+  // The size field must match the file size.
+  file.write({0x06030001, 0x0104, 1, 24, 0});
+  expectError(file.path, "header records 24 bytes but the file has 20");
+
+  file.write({0x06030102, 0x0104, 1, 20, 0});
+  expectError(file.path, "unsupported instruction file version 2.1");
+
+  if (mapError(file.path + ".missing").empty())
+    throw std::runtime_error("Failed to reject a missing file");
+}
+
+int main() {
+  test();
+  return 0;
+}
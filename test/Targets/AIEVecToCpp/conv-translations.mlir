@@ -0,0 +1,44 @@
+//===- conv-translations.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+// RUN: aie-translate %s -aie2 -aievec-to-cpp | FileCheck %s
+
+// The convolutions lowered to LLVM in
+// test/Conversion/AIEVecToLLVM/conv.mlir map to these AIE2 intrinsics.
+
+// CHECK-LABEL: v16acc64 i16_mul_conv(
+// CHECK-SAME:             v32int16 [[A:[a-zA-Z0-9]+]],
+// CHECK-SAME:             v16int16 [[B:[a-zA-Z0-9]+]]) {
+// CHECK:           v16acc64 [[R:.*]] = mul_conv_16x4([[A]], [[B]]);
+// CHECK:           return [[R]];
+// CHECK:        }
+func.func @i16_mul_conv(%arg0 : vector<32xi16>, %arg1 : vector<16xi16>) -> vector<16xi64> {
+  %0 = aievec.mul_conv %arg0, %arg1 {M = 16 : i32, N = 4 : i32} : vector<32xi16>, vector<16xi16>, vector<16xi64>
+  return %0 : vector<16xi64>
+}
+
+// CHECK-LABEL: v16acc64 i16_fma_conv(
+// CHECK-SAME:             v32int16 [[A:[a-zA-Z0-9]+]],
+// CHECK-SAME:             v16int16 [[B:[a-zA-Z0-9]+]],
+// CHECK-SAME:             v16acc64 [[C:[a-zA-Z0-9]+]]) {
+// CHECK:           [[C]] = mac_conv_16x4([[A]], [[B]], [[C]]);
+// CHECK:           return [[C]];
+// CHECK:        }
+func.func @i16_fma_conv(%arg0 : vector<32xi16>, %arg1 : vector<16xi16>, %arg2 : vector<16xi64>) -> vector<16xi64> {
+  %0 = aievec.fma_conv %arg0, %arg1, %arg2 {M = 16 : i32, N = 4 : i32} : vector<32xi16>, vector<16xi16>, vector<16xi64>
+  return %0 : vector<16xi64>
+}
+
+// CHECK-LABEL: v16acc64 i16_fms_conv(
+// CHECK:           [[C:.*]] = msc_conv_16x4(
+// CHECK:           return [[C]];
+func.func @i16_fms_conv(%arg0 : vector<32xi16>, %arg1 : vector<16xi16>, %arg2 : vector<16xi64>) -> vector<16xi64> {
+  %0 = aievec.fma_conv %arg0, %arg1, %arg2 {M = 16 : i32, N = 4 : i32, fmsub = true} : vector<32xi16>, vector<16xi16>, vector<16xi64>
+  return %0 : vector<16xi64>
+}
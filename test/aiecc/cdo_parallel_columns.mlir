@@ -0,0 +1,58 @@
+//===- cdo_parallel_columns.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// Loading the core ELFs of each column in parallel must produce the same CDO
+// as loading them serially.
+
+// RUN: rm -rf %t.serial %t.parallel
+// RUN: %PYTHON aiecc.py --no-xchesscc --no-xbridge --no-compile-host --aie-generate-cdo --tmpdir %t.serial %s
+// RUN: %PYTHON aiecc.py --no-xchesscc --no-xbridge --no-compile-host --aie-generate-cdo --cdo-parallel-columns --tmpdir %t.parallel %s
+// RUN: cmp %t.serial/aie_cdo_elfs.bin %t.parallel/aie_cdo_elfs.bin
+// RUN: cmp %t.serial/aie_cdo_init.bin %t.parallel/aie_cdo_init.bin
+// RUN: cmp %t.serial/aie_cdo_enable.bin %t.parallel/aie_cdo_enable.bin
+
+module {
+  aie.device(npu1_4col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %tile_1_2 = aie.tile(1, 2)
+    %tile_2_2 = aie.tile(2, 2)
+    %buf_0_2 = aie.buffer(%tile_0_2) : memref<256xi32>
+    %buf_0_3 = aie.buffer(%tile_0_3) : memref<256xi32>
+    %buf_1_2 = aie.buffer(%tile_1_2) : memref<256xi32>
+    %buf_2_2 = aie.buffer(%tile_2_2) : memref<256xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 2 : i32
+      memref.store %v, %buf_0_2[%c0] : memref<256xi32>
+      aie.end
+    }
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 3 : i32
+      memref.store %v, %buf_0_3[%c0] : memref<256xi32>
+      aie.end
+    }
+    %core_1_2 = aie.core(%tile_1_2) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 12 : i32
+      memref.store %v, %buf_1_2[%c0] : memref<256xi32>
+      aie.end
+    }
+    %core_2_2 = aie.core(%tile_2_2) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 22 : i32
+      memref.store %v, %buf_2_2[%c0] : memref<256xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,49 @@
+//===- incremental.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// An --incremental build reuses the previous build if only the runtime
+// sequence changed, and rebuilds if the device configuration changed or an
+// output of the previous build is missing.
+
+// RUN: rm -rf %t && mkdir -p %t && cd %t
+// RUN: sed 's/value = 1 :/value = 2 :/' %s > %t/sequence.mlir
+// RUN: sed 's/arith.constant 7 : i32/arith.constant 8 : i32/' %s > %t/core.mlir
+// RUN: %PYTHON aiecc.py -v --incremental --no-xchesscc --no-xbridge --no-compile-host --aie-generate-txn --tmpdir %t/tmp %s | FileCheck %s --check-prefix=BUILD
+// RUN: %PYTHON aiecc.py -v --incremental --no-xchesscc --no-xbridge --no-compile-host --aie-generate-txn --tmpdir %t/tmp %s | FileCheck %s --check-prefix=REUSE
+// RUN: %PYTHON aiecc.py -v --incremental --no-xchesscc --no-xbridge --no-compile-host --aie-generate-txn --tmpdir %t/tmp %t/sequence.mlir | FileCheck %s --check-prefix=REUSE
+// RUN: %PYTHON aiecc.py -v --incremental --no-xchesscc --no-xbridge --no-compile-host --aie-generate-txn --tmpdir %t/tmp %t/core.mlir | FileCheck %s --check-prefix=BUILD
+// RUN: rm %t/tmp/txn.mlir
+// RUN: %PYTHON aiecc.py -v --incremental --no-xchesscc --no-xbridge --no-compile-host --aie-generate-txn --tmpdir %t/tmp %t/core.mlir | FileCheck %s --check-prefix=BUILD
+// RUN: test -f %t/tmp/txn.mlir
+
+// BUILD-NOT: reusing previous build
+// BUILD: convert-aie-to-transaction
+// BUILD-NOT: reusing previous build
+
+// REUSE: Device configuration unchanged, reusing previous build
+// REUSE-NOT: convert-aie-to-transaction
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %buf_0_2 = aie.buffer(%tile_0_2) {sym_name = "buf_0_2"} : memref<16xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 7 : i32
+      memref.store %v, %buf_0_2[%c0] : memref<16xi32>
+      aie.end
+    }
+    aiex.runtime_sequence(%arg0: memref<16xi32>) {
+      aiex.npu.write32 {address = 2098576 : ui32, value = 1 : ui32}
+    }
+  }
+}
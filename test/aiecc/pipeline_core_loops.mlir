@@ -0,0 +1,35 @@
+//===- pipeline_core_loops.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// Core loops are only software pipelined when asked for.
+
+// RUN: rm -rf %t && mkdir -p %t && cd %t
+// RUN: %PYTHON aiecc.py -v -n --no-xchesscc --no-xbridge --no-compile-host --tmpdir %t/default %s | FileCheck %s --check-prefix=DEFAULT
+// RUN: %PYTHON aiecc.py -v -n --no-xchesscc --no-xbridge --no-compile-host --pipeline-core-loops --tmpdir %t/pipelined %s | FileCheck %s --check-prefix=PIPELINED
+
+// DEFAULT: aie-assign-buffer-addresses
+// DEFAULT-NOT: aie-pipeline-core-loops
+
+// PIPELINED: aie-assign-buffer-addresses{{.*}}aie-pipeline-core-loops
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %buf_0_2 = aie.buffer(%tile_0_2) : memref<256xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 7 : i32
+      memref.store %v, %buf_0_2[%c0] : memref<256xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,19 @@
+; Kernel for prune_kernel_ir.mlir: the core calls @scale, which reads
+; @scale_table. @offset and @offset_table are not reachable from the core.
+
+@scale_table = global [16 x i32] zeroinitializer
+@offset_table = global [64 x i32] zeroinitializer
+
+define i32 @scale(i32 %x) {
+  %p = getelementptr [16 x i32], ptr @scale_table, i32 0, i32 1
+  %s = load i32, ptr %p
+  %r = mul i32 %x, %s
+  ret i32 %r
+}
+
+define i32 @offset(i32 %x) {
+  %p = getelementptr [64 x i32], ptr @offset_table, i32 0, i32 1
+  %o = load i32, ptr %p
+  %r = add i32 %x, %o
+  ret i32 %r
+}
@@ -0,0 +1,42 @@
+//===- prune_kernel_ir.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// With --prune-kernel-ir, a kernel given as LLVM IR is linked into the core's
+// IR, without the functions and tables the core does not reach.
+
+// RUN: rm -rf %t && mkdir -p %t && cd %t && cp %S/prune_kernel.ll %t
+// RUN: %PYTHON aiecc.py --prune-kernel-ir --no-xchesscc --no-xbridge --no-unified --no-compile-host --tmpdir %t/tmp %s
+// RUN: FileCheck %s < %t/tmp/core_0_2.prune.txt
+// RUN: FileCheck %s --check-prefix=LDSCRIPT < %t/tmp/core_0_2.ld.script
+// RUN: test -f %t/core_0_2.elf
+
+// CHECK-DAG: removed function offset
+// CHECK-DAG: removed global offset_table (256 bytes)
+// CHECK-NOT: scale
+// CHECK: removed 1 functions and 1 globals, freeing 256 bytes of data memory
+
+// LDSCRIPT-NOT: prune_kernel.ll
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %buf_0_2 = aie.buffer(%tile_0_2) {sym_name = "buf_0_2"} : memref<16xi32>
+    func.func private @scale(i32) -> i32
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %v = memref.load %buf_0_2[%c0] : memref<16xi32>
+      %r = func.call @scale(%v) : (i32) -> i32
+      memref.store %r, %buf_0_2[%c0] : memref<16xi32>
+      aie.end
+    } {link_with = "prune_kernel.ll"}
+  }
+}
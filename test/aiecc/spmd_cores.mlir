@@ -0,0 +1,55 @@
+//===- spmd_cores.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc. or its affiliates
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// Two cores run the same code on their own buffers, so they share one object,
+// which is compiled once and linked into both ELFs.
+
+// RUN: rm -rf %t && mkdir -p %t && cd %t
+// RUN: %PYTHON aiecc.py -v --no-xchesscc --no-xbridge --no-unified --compile --link --no-compile-host --tmpdir %t/tmp %s > %t/log
+// RUN: FileCheck %s --check-prefix=LLC < %t/log
+// RUN: FileCheck %s --check-prefix=REUSE < %t/log
+// RUN: test -f %t/core_0_2.elf
+// RUN: test -f %t/core_0_3.elf
+
+// LLC: {{^[^ ]*llc}}
+// LLC-NOT: {{^[^ ]*llc}}
+
+// REUSE: Reusing {{.*}}core_0_{{[23]}}.o for core (0, {{[23]}})
+
+module {
+  aie.device(npu1_1col) {
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    %in_0_2 = aie.buffer(%tile_0_2) {sym_name = "in_0_2"} : memref<16xi32>
+    %out_0_2 = aie.buffer(%tile_0_2) {sym_name = "out_0_2"} : memref<16xi32>
+    %in_0_3 = aie.buffer(%tile_0_3) {sym_name = "in_0_3"} : memref<16xi32>
+    %out_0_3 = aie.buffer(%tile_0_3) {sym_name = "out_0_3"} : memref<16xi32>
+    // Not used by either core.
+    %scratch_0_3 = aie.buffer(%tile_0_3) {sym_name = "scratch_0_3"} : memref<16xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : i32
+      %v = memref.load %in_0_2[%c0] : memref<16xi32>
+      %r = arith.addi %v, %c1 : i32
+      memref.store %r, %out_0_2[%c0] : memref<16xi32>
+      aie.end
+    }
+    %core_0_3 = aie.core(%tile_0_3) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : i32
+      %v = memref.load %in_0_3[%c0] : memref<16xi32>
+      %r = arith.addi %v, %c1 : i32
+      memref.store %r, %out_0_3[%c0] : memref<16xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,85 @@
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=8" --aie-vectorize="shift=0 cross-iteration-reuse=true" -unaligned-loads-check=false -split-input-file | FileCheck %s
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=8" --aie-vectorize="shift=0" -unaligned-loads-check=false -split-input-file | FileCheck %s --check-prefix=DEFAULT
+
+// DEFAULT-NOT: iter_args
+
+// The upper half of each row window is carried over to the next iteration of
+// the vectorized loop, and only the new half is loaded.
+
+//CHECK-LABEL: func.func @conv2d(
+//CHECK-SAME:      %[[A:[a-zA-Z0-9]+]]: memref<2048x2048xi32>
+func.func @conv2d (%A: memref<2048x2048xi32>, %B: memref<9xi32>, %C: memref<2046x2046xi32>) {
+    affine.for %arg3 = 0 to 2046 {
+        affine.for %arg4 = 0 to 2046 {
+            //Load the output point
+            %ci = affine.load %C[%arg3, %arg4] : memref<2046x2046xi32>
+
+            //first point
+            %a11 = affine.load %A[%arg3, %arg4+0] : memref<2048x2048xi32>
+            %b11 = affine.load %B[0] : memref<9xi32>
+            %p11 = arith.muli %a11, %b11 : i32
+            %c11 = arith.addi %ci, %p11 : i32
+
+            //second point
+            %a12 = affine.load %A[%arg3, %arg4+1] : memref<2048x2048xi32>
+            %b12 = affine.load %B[1] : memref<9xi32>
+            %p12 = arith.muli %a12, %b12 : i32
+            %c12 = arith.addi %c11, %p12 : i32
+
+            //third point
+            %a13 = affine.load %A[%arg3, %arg4+2] : memref<2048x2048xi32>
+            %b13 = affine.load %B[2] : memref<9xi32>
+            %p13 = arith.muli %a13, %b13 : i32
+            %c13 = arith.addi %c12, %p13 : i32
+
+            //Store accumulated sum
+            affine.store %c13, %C[%arg3, %arg4] : memref<2046x2046xi32>
+        }
+    }
+    return
+}
+
+//CHECK:       scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+//CHECK:         %[[INIT:.*]] = aievec.upd %[[A]][%[[I]], %{{.*}}] {index = 0 : i8, offset = 0 : i32} : memref<2048x2048xi32>, vector<16xi32>
+//CHECK:         scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[LO:.*]] = %[[INIT]]) -> (vector<16xi32>) {
+//CHECK-NOT:       aievec.upd %[[A]]{{.*}}index = 0
+//CHECK:           aievec_aie1.mac %[[LO]],
+//CHECK:           %[[V:.*]] = aievec.upd %[[A]][%[[I]], %{{.*}}], %[[LO]] {index = 1 : i8, offset = 224 : i32} : memref<2048x2048xi32>, vector<16xi32>
+//CHECK:           %[[HI:.*]] = aievec_aie1.ext %[[V]] {index = 1 : i8} : vector<16xi32>, vector<8xi32>
+//CHECK:           %[[NEXT:.*]] = aievec.concat %[[HI]], %[[HI]] : vector<8xi32>, vector<16xi32>
+//CHECK:           aievec_aie1.mac %[[V]],
+//CHECK:           vector.transfer_write
+//CHECK:           scf.yield %[[NEXT]] : vector<16xi32>
+
+// -----
+
+// A row that is also written in the loop, even where it is not read, is
+// loaded again on every iteration.
+
+//CHECK-LABEL: func.func @conv1d_in_place(
+//CHECK-SAME:      %[[A:[a-zA-Z0-9]+]]: memref<2048xi32>
+//CHECK-NOT:     iter_args
+//CHECK:         scf.for
+//CHECK-NOT:     iter_args
+//CHECK:           %[[LO:.*]] = aievec.upd %[[A]][%{{.*}}] {index = 0 : i8, offset = 0 : i32}
+//CHECK:           aievec.upd %[[A]][%{{.*}}], %[[LO]] {index = 1 : i8, offset = 224 : i32}
+func.func @conv1d_in_place(%A: memref<2048xi32>, %B: memref<3xi32>) {
+    affine.for %arg4 = 0 to 1016 {
+        %a1 = affine.load %A[%arg4+0] : memref<2048xi32>
+        %b1 = affine.load %B[0] : memref<3xi32>
+        %p1 = arith.muli %a1, %b1 : i32
+
+        %a2 = affine.load %A[%arg4+1] : memref<2048xi32>
+        %b2 = affine.load %B[1] : memref<3xi32>
+        %p2 = arith.muli %a2, %b2 : i32
+        %c2 = arith.addi %p1, %p2 : i32
+
+        %a3 = affine.load %A[%arg4+2] : memref<2048xi32>
+        %b3 = affine.load %B[2] : memref<3xi32>
+        %p3 = arith.muli %a3, %b3 : i32
+        %c3 = arith.addi %c2, %p3 : i32
+
+        affine.store %c3, %A[%arg4+1024] : memref<2048xi32>
+    }
+    return
+}
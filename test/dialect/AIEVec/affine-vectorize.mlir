@@ -0,0 +1,114 @@
+// RUN: aie-opt %s -affine-vectorize-for-aievec=aie-target=aie2 -split-input-file | FileCheck %s
+// RUN: aie-opt %s -affine-vectorize-for-aievec=aie-target=aie2p -split-input-file | FileCheck %s
+
+// AIE2P only differs from AIE2 in its 32-lane bf16 MAC, which makes wide
+// vectors cheaper but never changes which width is cheapest, so both targets
+// are checked against the same widths.
+
+// i8 elementwise ops are bound by the loads and stores, so the widest
+// register-sized vector wins.
+
+// CHECK-LABEL: func.func @add_i8
+// CHECK: affine.for %{{.*}} = 0 to 1024 step 64 {
+// CHECK: vector.transfer_read {{.*}} : memref<1024xi8>, vector<64xi8>
+// CHECK: arith.addi {{.*}} : vector<64xi8>
+// CHECK: vector.transfer_write {{.*}} : vector<64xi8>, memref<1024xi8>
+func.func @add_i8(%a : memref<1024xi8>, %b : memref<1024xi8>, %c : memref<1024xi8>) {
+  affine.for %i = 0 to 1024 {
+    %0 = affine.load %a[%i] : memref<1024xi8>
+    %1 = affine.load %b[%i] : memref<1024xi8>
+    %2 = arith.addi %0, %1 : i8
+    affine.store %2, %c[%i] : memref<1024xi8>
+  }
+  return
+}
+
+// -----
+
+// A bf16 multiply accumulates in f32. Two 16-lane MACs per 32 lanes still
+// keep up with the loads and the store of the narrowed result.
+
+// CHECK-LABEL: func.func @mul_bf16
+// CHECK: affine.for %{{.*}} = 0 to 256 step 32 {
+// CHECK: vector.transfer_read {{.*}} : memref<256xbf16>, vector<32xbf16>
+// CHECK: arith.mulf {{.*}} : vector<32xf32>
+// CHECK: vector.transfer_write {{.*}} : vector<32xbf16>, memref<256xbf16>
+func.func @mul_bf16(%a : memref<256xbf16>, %b : memref<256xbf16>, %c : memref<256xbf16>) {
+  affine.for %i = 0 to 256 {
+    %0 = affine.load %a[%i] : memref<256xbf16>
+    %1 = affine.load %b[%i] : memref<256xbf16>
+    %2 = arith.extf %0 : bf16 to f32
+    %3 = arith.extf %1 : bf16 to f32
+    %4 = arith.mulf %2, %3 : f32
+    %5 = arith.truncf %4 : f32 to bf16
+    affine.store %5, %c[%i] : memref<256xbf16>
+  }
+  return
+}
+
+// -----
+
+// Three bf16 MACs per element make the MAC slot the bottleneck on AIE2,
+// which needs two 16-lane MACs per 32 lanes. AIE2P does 32 lanes in one MAC.
+// Either way, 32 lanes are still the cheapest.
+
+// CHECK-LABEL: func.func @mac3_bf16
+// CHECK: affine.for %{{.*}} = 0 to 256 step 32 {
+// CHECK-COUNT-3: arith.mulf {{.*}} : vector<32xf32>
+// CHECK: vector.transfer_write {{.*}} : vector<32xbf16>, memref<256xbf16>
+func.func @mac3_bf16(%a : memref<256xbf16>, %b : memref<256xbf16>, %c : memref<256xbf16>, %d : memref<256xbf16>) {
+  affine.for %i = 0 to 256 {
+    %0 = affine.load %a[%i] : memref<256xbf16>
+    %1 = affine.load %b[%i] : memref<256xbf16>
+    %2 = affine.load %c[%i] : memref<256xbf16>
+    %3 = arith.extf %0 : bf16 to f32
+    %4 = arith.extf %1 : bf16 to f32
+    %5 = arith.extf %2 : bf16 to f32
+    %6 = arith.mulf %3, %4 : f32
+    %7 = arith.mulf %3, %5 : f32
+    %8 = arith.mulf %4, %5 : f32
+    %9 = arith.addf %6, %7 : f32
+    %10 = arith.addf %9, %8 : f32
+    %11 = arith.truncf %10 : f32 to bf16
+    affine.store %11, %d[%i] : memref<256xbf16>
+  }
+  return
+}
+
+// -----
+
+// An i8 x i8 -> i32 multiply uses 32-lane acc32 MACs; the i32 result limits
+// the width to 32 lanes.
+
+// CHECK-LABEL: func.func @mul_i8_i32
+// CHECK: affine.for %{{.*}} = 0 to 256 step 32 {
+// CHECK: vector.transfer_read {{.*}} : memref<256xi8>, vector<32xi8>
+// CHECK: arith.muli {{.*}} : vector<32xi32>
+// CHECK: vector.transfer_write {{.*}} : vector<32xi32>, memref<256xi32>
+func.func @mul_i8_i32(%a : memref<256xi8>, %b : memref<256xi8>, %c : memref<256xi32>) {
+  affine.for %i = 0 to 256 {
+    %0 = affine.load %a[%i] : memref<256xi8>
+    %1 = affine.load %b[%i] : memref<256xi8>
+    %2 = arith.extsi %0 : i8 to i32
+    %3 = arith.extsi %1 : i8 to i32
+    %4 = arith.muli %2, %3 : i32
+    affine.store %4, %c[%i] : memref<256xi32>
+  }
+  return
+}
+
+// -----
+
+// The width must divide the trip count.
+
+// CHECK-LABEL: func.func @add_i16_48
+// CHECK: affine.for %{{.*}} = 0 to 48 step 16 {
+// CHECK: arith.addi {{.*}} : vector<16xi16>
+func.func @add_i16_48(%a : memref<48xi16>, %b : memref<48xi16>) {
+  affine.for %i = 0 to 48 {
+    %0 = affine.load %a[%i] : memref<48xi16>
+    %1 = arith.addi %0, %0 : i16
+    affine.store %1, %b[%i] : memref<48xi16>
+  }
+  return
+}
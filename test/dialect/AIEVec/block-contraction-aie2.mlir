@@ -0,0 +1,145 @@
+// RUN: aie-opt %s -split-input-file -canonicalize-vector-for-aievec=aie-target=aie2 -canonicalize -cse | FileCheck %s
+// RUN: aie-opt %s -split-input-file -convert-vector-to-aievec="aie-target=aie2 target-backend=llvmir" | FileCheck %s --check-prefix=MATMUL
+
+// A 2x2 block of native i8 matmuls: each slice of A and B is read once and
+// used by two contractions, each contraction has its own accumulator.
+
+#mapA = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+#mapB = affine_map<(d0, d1, d2, d3, d4, d5) -> (d2, d1, d5, d4)>
+#mapC = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+
+// CHECK-LABEL: func.func @matmul_block_2x2_i8(
+// CHECK-COUNT-2: vector.transfer_read {{.*}} : memref<64xi8>, vector<32xi8>
+// CHECK-COUNT-2: vector.transfer_read {{.*}} : memref<128xi8>, vector<64xi8>
+// CHECK-COUNT-4: vector.transfer_read {{.*}} : memref<256xi32>, vector<32xi32>
+// CHECK-COUNT-4: vector.contract {{.*}} into vector<1x1x4x8xi32>
+// CHECK-NOT:     vector.contract
+// CHECK-COUNT-4: vector.transfer_write {{.*}} : vector<32xi32>, memref<256xi32>
+// CHECK-NOT:     vector.transfer_write
+
+// MATMUL-LABEL: func.func @matmul_block_2x2_i8(
+// MATMUL-COUNT-4: aievec.matmul {{.*}} : vector<4x8xi8>, vector<8x8xi8> into vector<4x8xi32>
+// MATMUL-NOT:     vector.contract
+func.func @matmul_block_2x2_i8(%A : memref<2x1x4x8xi8>,
+                               %B : memref<1x2x8x8xi8>,
+                               %C : memref<2x2x4x8xi32>) {
+  %c0 = arith.constant 0 : index
+  %c0_i8 = arith.constant 0 : i8
+  %c0_i32 = arith.constant 0 : i32
+  %a = vector.transfer_read %A[%c0, %c0, %c0, %c0], %c0_i8
+         {in_bounds = [true, true, true, true]} :
+         memref<2x1x4x8xi8>, vector<2x1x4x8xi8>
+  %b = vector.transfer_read %B[%c0, %c0, %c0, %c0], %c0_i8
+         {in_bounds = [true, true, true, true]} :
+         memref<1x2x8x8xi8>, vector<1x2x8x8xi8>
+  %c = vector.transfer_read %C[%c0, %c0, %c0, %c0], %c0_i32
+         {in_bounds = [true, true, true, true]} :
+         memref<2x2x4x8xi32>, vector<2x2x4x8xi32>
+  %lhs = arith.extsi %a : vector<2x1x4x8xi8> to vector<2x1x4x8xi32>
+  %rhs = arith.extsi %b : vector<1x2x8x8xi8> to vector<1x2x8x8xi32>
+  %res = vector.contract {
+           indexing_maps = [#mapA, #mapB, #mapC],
+           iterator_types = ["parallel", "parallel", "reduction",
+                             "parallel", "parallel", "reduction"],
+           kind = #vector.kind<add>} %lhs, %rhs, %c :
+           vector<2x1x4x8xi32>, vector<1x2x8x8xi32> into vector<2x2x4x8xi32>
+  vector.transfer_write %res, %C[%c0, %c0, %c0, %c0]
+         {in_bounds = [true, true, true, true]} :
+         vector<2x2x4x8xi32>, memref<2x2x4x8xi32>
+  return
+}
+
+// -----
+
+// A 1x2 block of native bf16 matmuls sharing the same A operand.
+
+#mapA = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+#mapB = affine_map<(d0, d1, d2, d3, d4, d5) -> (d2, d1, d5, d4)>
+#mapC = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+
+// CHECK-LABEL: func.func @matmul_block_1x2_bf16(
+// CHECK-COUNT-2: vector.transfer_read {{.*}} : memref<64xbf16>, vector<32xbf16>
+// CHECK-COUNT-2: vector.contract {{.*}} into vector<1x1x4x4xf32>
+// CHECK-NOT:     vector.contract
+
+// MATMUL-LABEL: func.func @matmul_block_1x2_bf16(
+// MATMUL-COUNT-2: aievec.matmul {{.*}} : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+// MATMUL-NOT:     vector.contract
+func.func @matmul_block_1x2_bf16(%A : vector<1x1x4x8xbf16>,
+                                 %B : memref<1x2x8x4xbf16>,
+                                 %C : vector<1x2x4x4xf32>)
+                                -> vector<1x2x4x4xf32> {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.0 : bf16
+  %b = vector.transfer_read %B[%c0, %c0, %c0, %c0], %cst
+         {in_bounds = [true, true, true, true]} :
+         memref<1x2x8x4xbf16>, vector<1x2x8x4xbf16>
+  %lhs = arith.extf %A : vector<1x1x4x8xbf16> to vector<1x1x4x8xf32>
+  %rhs = arith.extf %b : vector<1x2x8x4xbf16> to vector<1x2x8x4xf32>
+  %res = vector.contract {
+           indexing_maps = [#mapA, #mapB, #mapC],
+           iterator_types = ["parallel", "parallel", "reduction",
+                             "parallel", "parallel", "reduction"],
+           kind = #vector.kind<add>} %lhs, %rhs, %C :
+           vector<1x1x4x8xf32>, vector<1x2x8x4xf32> into vector<1x2x4x4xf32>
+  return %res : vector<1x2x4x4xf32>
+}
+
+// -----
+
+// A 2x2 block accumulated across the reduction loop. The accumulators stay
+// in the loop-carried value; C is only read before and written after the
+// loop.
+
+#mapA = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+#mapB = affine_map<(d0, d1, d2, d3, d4, d5) -> (d2, d1, d5, d4)>
+#mapC = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+
+// CHECK-LABEL: func.func @matmul_block_2x2_i8_loop(
+// CHECK:         scf.for {{.*}} iter_args(
+// CHECK-NOT:       vector.transfer_write
+// CHECK-COUNT-4:   vector.contract {{.*}} into vector<1x1x4x8xi32>
+// CHECK-NOT:       vector.contract
+// CHECK-NOT:       vector.transfer_write
+// CHECK:           scf.yield
+// CHECK:         vector.transfer_write
+
+// MATMUL-LABEL: func.func @matmul_block_2x2_i8_loop(
+// MATMUL:         scf.for {{.*}} iter_args(
+// MATMUL-COUNT-4:   aievec.matmul {{.*}} : vector<4x8xi8>, vector<8x8xi8> into vector<4x8xi32>
+// MATMUL-NOT:       vector.contract
+// MATMUL:           scf.yield
+func.func @matmul_block_2x2_i8_loop(%A : memref<2x4x4x8xi8>,
+                                    %B : memref<4x2x8x8xi8>,
+                                    %C : memref<2x2x4x8xi32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c0_i8 = arith.constant 0 : i8
+  %c0_i32 = arith.constant 0 : i32
+  %init = vector.transfer_read %C[%c0, %c0, %c0, %c0], %c0_i32
+            {in_bounds = [true, true, true, true]} :
+            memref<2x2x4x8xi32>, vector<2x2x4x8xi32>
+  %res = scf.for %k = %c0 to %c4 step %c1
+           iter_args(%acc = %init) -> (vector<2x2x4x8xi32>) {
+    %a = vector.transfer_read %A[%c0, %k, %c0, %c0], %c0_i8
+           {in_bounds = [true, true, true, true]} :
+           memref<2x4x4x8xi8>, vector<2x1x4x8xi8>
+    %b = vector.transfer_read %B[%k, %c0, %c0, %c0], %c0_i8
+           {in_bounds = [true, true, true, true]} :
+           memref<4x2x8x8xi8>, vector<1x2x8x8xi8>
+    %lhs = arith.extsi %a : vector<2x1x4x8xi8> to vector<2x1x4x8xi32>
+    %rhs = arith.extsi %b : vector<1x2x8x8xi8> to vector<1x2x8x8xi32>
+    %next = vector.contract {
+              indexing_maps = [#mapA, #mapB, #mapC],
+              iterator_types = ["parallel", "parallel", "reduction",
+                                "parallel", "parallel", "reduction"],
+              kind = #vector.kind<add>} %lhs, %rhs, %acc :
+              vector<2x1x4x8xi32>, vector<1x2x8x8xi32> into vector<2x2x4x8xi32>
+    scf.yield %next : vector<2x2x4x8xi32>
+  }
+  vector.transfer_write %res, %C[%c0, %c0, %c0, %c0]
+         {in_bounds = [true, true, true, true]} :
+         vector<2x2x4x8xi32>, memref<2x2x4x8xi32>
+  return
+}
@@ -0,0 +1,151 @@
+// RUN: aie-opt %s -split-input-file -canonicalize-vector-for-aievec="aie-target=aie2 reduction-accumulators=4" -canonicalize -cse | FileCheck %s
+// RUN: aie-opt %s -split-input-file -canonicalize-vector-for-aievec=aie-target=aie2 -canonicalize -cse | FileCheck %s --check-prefix=SINGLE
+// RUN: aie-opt %s -split-input-file -canonicalize-vector-for-aievec="aie-target=aie2 reduction-accumulators=1" -canonicalize -cse | FileCheck %s --check-prefix=SINGLE
+
+// CHECK-LABEL: func.func @reduce_add_i32(
+// CHECK:         %[[Z:.*]] = arith.constant dense<0> : vector<16xi32>
+// CHECK:         %[[R:.*]]:4 = affine.for %{{.*}} = 0 to 1024 step 64
+// CHECK-SAME:        iter_args(%[[A0:.*]] = %[[Z]], %[[A1:.*]] = %[[Z]],
+// CHECK-SAME:                  %[[A2:.*]] = %[[Z]], %[[A3:.*]] = %[[Z]])
+// CHECK:           %[[S0:.*]] = arith.addi %[[A0]], %{{.*}} : vector<16xi32>
+// CHECK:           %[[S1:.*]] = arith.addi %[[A1]], %{{.*}} : vector<16xi32>
+// CHECK:           %[[S2:.*]] = arith.addi %[[A2]], %{{.*}} : vector<16xi32>
+// CHECK:           %[[S3:.*]] = arith.addi %[[A3]], %{{.*}} : vector<16xi32>
+// CHECK:           affine.yield %[[S0]], %[[S1]], %[[S2]], %[[S3]]
+// CHECK:         %[[C1:.*]] = arith.addi %[[R]]#0, %[[R]]#1 : vector<16xi32>
+// CHECK:         %[[C2:.*]] = arith.addi %[[C1]], %[[R]]#2 : vector<16xi32>
+// CHECK:         %[[C3:.*]] = arith.addi %[[C2]], %[[R]]#3 : vector<16xi32>
+// CHECK:         %[[RED:.*]] = vector.reduction <add>, %[[C3]] : vector<16xi32> into i32
+// CHECK:         return %[[RED]] : i32
+
+// SINGLE-LABEL: func.func @reduce_add_i32(
+// SINGLE:         affine.for %{{.*}} = 0 to 1024 step 16 iter_args(%{{.*}} = %{{.*}}) -> (vector<16xi32>)
+func.func @reduce_add_i32(%in : memref<1024xi32>) -> i32 {
+  %c0_i32 = arith.constant 0 : i32
+  %zero = arith.constant dense<0> : vector<16xi32>
+  %acc = affine.for %i = 0 to 1024 step 16 iter_args(%a = %zero) -> (vector<16xi32>) {
+    %v = vector.transfer_read %in[%i], %c0_i32 : memref<1024xi32>, vector<16xi32>
+    %s = arith.addi %a, %v : vector<16xi32>
+    affine.yield %s : vector<16xi32>
+  }
+  %r = vector.reduction <add>, %acc : vector<16xi32> into i32
+  return %r : i32
+}
+
+// -----
+
+// A scalar accumulator reduced on every iteration is kept in vector
+// accumulators and reduced once after the loop. This reassociates the
+// floating-point sum, which the reduction allows.
+
+// CHECK-LABEL: func.func @reduce_add_scalar_f32(
+// CHECK-SAME:      %{{.*}}: memref<256xf32>, %[[INIT:.*]]: f32)
+// CHECK:         %[[ID:.*]] = arith.constant dense<{{.*}}> : vector<16xf32>
+// CHECK:         %[[R:.*]]:4 = scf.for
+// CHECK-SAME:        iter_args(%[[A0:.*]] = %[[ID]], %[[A1:.*]] = %[[ID]],
+// CHECK-SAME:                  %[[A2:.*]] = %[[ID]], %[[A3:.*]] = %[[ID]])
+// CHECK-SAME:        -> (vector<16xf32>, vector<16xf32>, vector<16xf32>, vector<16xf32>)
+// CHECK-NOT:       vector.reduction
+// CHECK:           %[[S0:.*]] = arith.addf %{{.*}}, %[[A0]] fastmath<reassoc> : vector<16xf32>
+// CHECK:           %[[S1:.*]] = arith.addf %{{.*}}, %[[A1]] fastmath<reassoc> : vector<16xf32>
+// CHECK:           %[[S2:.*]] = arith.addf %{{.*}}, %[[A2]] fastmath<reassoc> : vector<16xf32>
+// CHECK:           %[[S3:.*]] = arith.addf %{{.*}}, %[[A3]] fastmath<reassoc> : vector<16xf32>
+// CHECK:           scf.yield %[[S0]], %[[S1]], %[[S2]], %[[S3]]
+// CHECK:         %[[C1:.*]] = arith.addf %[[R]]#0, %[[R]]#1 fastmath<reassoc> : vector<16xf32>
+// CHECK:         %[[C2:.*]] = arith.addf %[[C1]], %[[R]]#2 fastmath<reassoc> : vector<16xf32>
+// CHECK:         %[[C3:.*]] = arith.addf %[[C2]], %[[R]]#3 fastmath<reassoc> : vector<16xf32>
+// CHECK:         %[[RED:.*]] = vector.reduction <add>, %[[C3]], %[[INIT]] : vector<16xf32> into f32
+// CHECK:         return %[[RED]] : f32
+
+// SINGLE-LABEL: func.func @reduce_add_scalar_f32(
+// SINGLE:         scf.for {{.*}} -> (f32) {
+// SINGLE:           vector.reduction <add>
+// SINGLE:           scf.yield
+func.func @reduce_add_scalar_f32(%in : memref<256xf32>, %init : f32) -> f32 {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %cst = arith.constant 0.0 : f32
+  %r = scf.for %i = %c0 to %c256 step %c16 iter_args(%a = %init) -> (f32) {
+    %v = vector.transfer_read %in[%i], %cst : memref<256xf32>, vector<16xf32>
+    %s = vector.reduction <add>, %v, %a fastmath<reassoc> : vector<16xf32> into f32
+    scf.yield %s : f32
+  }
+  return %r : f32
+}
+
+// -----
+
+// The loop is split by the largest factor that divides its trip count.
+
+// CHECK-LABEL: func.func @reduce_max_i16(
+// CHECK:         %[[ID:.*]] = arith.constant dense<-32768> : vector<32xi16>
+// CHECK:         %[[R:.*]]:3 = affine.for %{{.*}} = 0 to 192 step 96
+// CHECK-SAME:        iter_args(%{{.*}} = %[[ID]], %{{.*}} = %[[ID]], %{{.*}} = %[[ID]])
+// CHECK:         %[[C1:.*]] = arith.maxsi %[[R]]#0, %[[R]]#1 : vector<32xi16>
+// CHECK:         %[[C2:.*]] = arith.maxsi %[[C1]], %[[R]]#2 : vector<32xi16>
+// CHECK:         vector.reduction <maxsi>, %[[C2]] : vector<32xi16> into i16
+func.func @reduce_max_i16(%in : memref<192xi16>) -> i16 {
+  %c0_i16 = arith.constant 0 : i16
+  %min = arith.constant dense<-32768> : vector<32xi16>
+  %acc = affine.for %i = 0 to 192 step 32 iter_args(%a = %min) -> (vector<32xi16>) {
+    %v = vector.transfer_read %in[%i], %c0_i16 : memref<192xi16>, vector<32xi16>
+    %m = arith.maxsi %a, %v : vector<32xi16>
+    affine.yield %m : vector<32xi16>
+  }
+  %r = vector.reduction <maxsi>, %acc : vector<32xi16> into i16
+  return %r : i16
+}
+
+// -----
+
+// Without a known trip count the loop is not unrolled, but the scalar
+// accumulator is still moved out of the loop.
+
+// CHECK-LABEL: func.func @reduce_max_dynamic(
+// CHECK-SAME:      %{{.*}}: memref<?xbf16>, %{{.*}}: index, %[[INIT:.*]]: bf16)
+// CHECK:         %[[ID:.*]] = arith.constant dense<{{.*}}> : vector<32xbf16>
+// CHECK:         %[[R:.*]] = scf.for {{.*}} iter_args(%[[A:.*]] = %[[ID]]) -> (vector<32xbf16>) {
+// CHECK:           %[[M:.*]] = arith.maximumf %{{.*}}, %[[A]] : vector<32xbf16>
+// CHECK:           scf.yield %[[M]] : vector<32xbf16>
+// CHECK:         %[[RED:.*]] = vector.reduction <maximumf>, %[[R]], %[[INIT]] : vector<32xbf16> into bf16
+// CHECK:         return %[[RED]] : bf16
+func.func @reduce_max_dynamic(%in : memref<?xbf16>, %n : index, %init : bf16) -> bf16 {
+  %c0 = arith.constant 0 : index
+  %c32 = arith.constant 32 : index
+  %cst = arith.constant 0.0 : bf16
+  %r = scf.for %i = %c0 to %n step %c32 iter_args(%a = %init) -> (bf16) {
+    %v = vector.transfer_read %in[%i], %cst : memref<?xbf16>, vector<32xbf16>
+    %s = vector.reduction <maximumf>, %v : vector<32xbf16> into bf16
+    %m = arith.maximumf %a, %s : bf16
+    scf.yield %m : bf16
+  }
+  return %r : bf16
+}
+
+// -----
+
+// Without reassociation, floating-point sums keep their order.
+
+// CHECK-LABEL: func.func @reduce_add_strict_f32(
+// CHECK:         affine.for %{{.*}} = 0 to 256 step 16 iter_args(%{{.*}} = %{{.*}}) -> (f32) {
+// CHECK:           vector.reduction <add>
+// CHECK:         affine.for %{{.*}} = 0 to 256 step 16 iter_args(%{{.*}} = %{{.*}}) -> (vector<16xf32>) {
+// CHECK-NEXT:      vector.transfer_read
+// CHECK-NEXT:      arith.addf
+// CHECK-NEXT:      affine.yield
+func.func @reduce_add_strict_f32(%in : memref<256xf32>, %init : f32) -> (f32, vector<16xf32>) {
+  %cst = arith.constant 0.0 : f32
+  %zero = arith.constant dense<0.0> : vector<16xf32>
+  %r = affine.for %i = 0 to 256 step 16 iter_args(%a = %init) -> (f32) {
+    %v = vector.transfer_read %in[%i], %cst : memref<256xf32>, vector<16xf32>
+    %s = vector.reduction <add>, %v, %a : vector<16xf32> into f32
+    affine.yield %s : f32
+  }
+  %acc = affine.for %i = 0 to 256 step 16 iter_args(%a = %zero) -> (vector<16xf32>) {
+    %v = vector.transfer_read %in[%i], %cst : memref<256xf32>, vector<16xf32>
+    %s = arith.addf %a, %v : vector<16xf32>
+    affine.yield %s : vector<16xf32>
+  }
+  return %r, %acc : f32, vector<16xf32>
+}
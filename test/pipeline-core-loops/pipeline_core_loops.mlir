@@ -0,0 +1,128 @@
+//===- pipeline_core_loops.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-pipeline-core-loops %s | FileCheck %s
+
+// The loads of the next iteration are issued ahead of the MAC of the current
+// one and carried in loop registers.
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:         %[[A:.*]] = aie.buffer({{.*}}) {sym_name = "a"}
+// CHECK:         %[[B:.*]] = aie.buffer({{.*}}) {sym_name = "b"}
+// CHECK:         aie.core
+// CHECK:           %[[A0:.*]] = vector.load %[[A]][%{{.*}}] : memref<256xi16>, vector<32xi16>
+// CHECK:           %[[B0:.*]] = vector.load %[[B]][%{{.*}}] : memref<256xi16>, vector<32xi16>
+// CHECK:           %[[R:.*]]:3 = scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}}
+// CHECK-SAME:          iter_args(%[[ACC:.*]] = %{{.*}}, %[[VA:.*]] = %[[A0]], %[[VB:.*]] = %[[B0]])
+// CHECK:             %[[NA:.*]] = vector.load %[[A]]
+// CHECK:             %[[NB:.*]] = vector.load %[[B]]
+// CHECK:             %[[M:.*]] = arith.muli %[[VA]], %[[VB]] : vector<32xi16>
+// CHECK:             %[[S:.*]] = arith.addi %[[ACC]], %[[M]] : vector<32xi16>
+// CHECK:             scf.yield %[[S]], %[[NA]], %[[NB]]
+// CHECK:           %[[LM:.*]] = arith.muli %[[R]]#1, %[[R]]#2 : vector<32xi16>
+// CHECK:           %[[LS:.*]] = arith.addi %[[R]]#0, %[[LM]] : vector<32xi16>
+// CHECK:           vector.store %[[LS]]
+module {
+  aie.device(npu1_1col) {
+    %t = aie.tile(0, 2)
+    %a = aie.buffer(%t) {sym_name = "a"} : memref<256xi16>
+    %b = aie.buffer(%t) {sym_name = "b"} : memref<256xi16>
+    %c = aie.buffer(%t) {sym_name = "c"} : memref<32xi16>
+    aie.core(%t) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %c32 = arith.constant 32 : index
+      %zero = arith.constant dense<0> : vector<32xi16>
+      %acc = scf.for %i = %c0 to %c8 step %c1 iter_args(%sum = %zero) -> (vector<32xi16>) {
+        %idx = arith.muli %i, %c32 : index
+        %va = vector.load %a[%idx] : memref<256xi16>, vector<32xi16>
+        %vb = vector.load %b[%idx] : memref<256xi16>, vector<32xi16>
+        %m = arith.muli %va, %vb : vector<32xi16>
+        %s = arith.addi %sum, %m : vector<32xi16>
+        scf.yield %s : vector<32xi16>
+      }
+      vector.store %acc, %c[%c0] : memref<32xi16>, vector<32xi16>
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// Loads from a buffer the loop also stores to are not moved ahead of the
+// store; loads from other buffers still are.
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:         %[[A:.*]] = aie.buffer({{.*}}) {sym_name = "a"}
+// CHECK:         %[[C:.*]] = aie.buffer({{.*}}) {sym_name = "c"}
+// CHECK:         aie.core
+// CHECK:           %[[A0:.*]] = vector.load %[[A]]
+// CHECK-NOT:       vector.load %[[C]]
+// CHECK:           scf.for {{.*}} iter_args(
+// CHECK-SAME:          %[[A0]]
+// CHECK:             vector.load %[[A]]
+// CHECK:             %[[VC:.*]] = vector.load %[[C]]
+// CHECK:             arith.addi %{{.*}}, %[[VC]]
+// CHECK:             vector.store %{{.*}}, %[[C]]
+module {
+  aie.device(npu1_1col) {
+    %t = aie.tile(0, 2)
+    %a = aie.buffer(%t) {sym_name = "a"} : memref<256xi16>
+    %c = aie.buffer(%t) {sym_name = "c"} : memref<256xi16>
+    aie.core(%t) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %c32 = arith.constant 32 : index
+      scf.for %i = %c0 to %c8 step %c1 {
+        %idx = arith.muli %i, %c32 : index
+        %va = vector.load %a[%idx] : memref<256xi16>, vector<32xi16>
+        %vc = vector.load %c[%idx] : memref<256xi16>, vector<32xi16>
+        %s = arith.addi %va, %vc : vector<32xi16>
+        vector.store %s, %c[%idx] : memref<256xi16>, vector<32xi16>
+      }
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// Loops that synchronize through locks are left alone.
+
+// CHECK-LABEL: aie.device(npu1_1col)
+// CHECK:         aie.core
+// CHECK:           scf.for
+// CHECK-NOT:           iter_args
+// CHECK:             aie.use_lock
+// CHECK:             vector.load
+module {
+  aie.device(npu1_1col) {
+    %t = aie.tile(0, 2)
+    %l = aie.lock(%t, 0)
+    %a = aie.buffer(%t) {sym_name = "a"} : memref<256xi16>
+    %c = aie.buffer(%t) {sym_name = "c"} : memref<256xi16>
+    aie.core(%t) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c8 = arith.constant 8 : index
+      %c32 = arith.constant 32 : index
+      scf.for %i = %c0 to %c8 step %c1 {
+        aie.use_lock(%l, AcquireGreaterEqual, 1)
+        %idx = arith.muli %i, %c32 : index
+        %va = vector.load %a[%idx] : memref<256xi16>, vector<32xi16>
+        vector.store %va, %c[%idx] : memref<256xi16>, vector<32xi16>
+        aie.use_lock(%l, Release, 1)
+      }
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,74 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# RUN: %python %s | FileCheck %s
+
+import os
+import sys
+import tempfile
+import types
+
+import numpy as np
+
+# Header validation and instruction caching do not need a device; stub out
+# pyxrt so that aie.utils.xrt can be imported without XRT installed.
+try:
+    import pyxrt
+except ImportError:
+    pyxrt = types.ModuleType("pyxrt")
+    pyxrt.bo = types.SimpleNamespace(host_only=0)
+    sys.modules["pyxrt"] = pyxrt
+from aie.utils.xrt import AIE_Application_Error, map_insts_binary, read_insts
+
+
+def write_insts(path, words):
+    np.array(words, dtype=np.uint32).tofile(path)
+
+
+def try_map(path, expected_dev_gen=None):
+    try:
+        insts = map_insts_binary(path, expected_dev_gen)
+        print("ok", insts.size, (insts[0] >> 16) & 0xFF)
+    except AIE_Application_Error as e:
+        print("error:", str(e).replace(path, "<file>"))
+
+
+with tempfile.TemporaryDirectory() as d:
+    path = os.path.join(d, "insts.bin")
+
+    # CHECK: ok 5 3
+    write_insts(path, [0x00030001, 0x0401, 1, 20, 0xCAFE])
+    try_map(path)
+
+    # CHECK: error: <file>: targets device generation 3, expected 4
+    try_map(path, expected_dev_gen=4)
+
+    # CHECK: error: <file>: file is truncated
+    write_insts(path, [0x00030001, 0x0401])
+    try_map(path)
+
+    # CHECK: error: <file>: file is truncated
+    with open(path, "wb") as f:
+        f.write(b"\x01\x00\x03\x00\x01\x04\x00\x00\x01\x00\x00\x00\x11")
+    try_map(path)
+
+    # CHECK: error: <file>: unsupported instruction file version 2.1
+    write_insts(path, [0x00030102, 0x0401, 1, 20, 0])
+    try_map(path)
+
+    # CHECK: error: <file>: header records 24 bytes but the file has 20
+    write_insts(path, [0x00030001, 0x0401, 1, 24, 0])
+    try_map(path)
+
+    # A file rebuilt in the same process is read again instead of being served
+    # from the cache.
+    # CHECK: 51966
+    # CHECK: 48879
+    write_insts(path, [0x00030001, 0x0401, 1, 20, 0xCAFE])
+    print(read_insts(path)[4])
+    write_insts(path, [0x00030001, 0x0401, 1, 24, 0xBEEF, 0])
+    os.utime(path, ns=(0, 1))
+    print(read_insts(path)[4])
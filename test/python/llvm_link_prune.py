@@ -0,0 +1,59 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+from textwrap import dedent
+
+from aie.dialects.aie import aie_llvm_link_pruned
+
+core = dedent(
+    """\
+    declare float @exp_lut(float)
+
+    define void @core_0_2(ptr %out) {
+      %v = call float @exp_lut(float 1.0)
+      store float %v, ptr %out
+      ret void
+    }
+    """
+)
+
+kernels = dedent(
+    """\
+    @exp_ilut_ab = global [512 x i8] zeroinitializer
+    @tanh_lut_ab = global [256 x i8] zeroinitializer
+
+    define float @exp_lut(float %x) {
+      %p = getelementptr [512 x i8], ptr @exp_ilut_ab, i32 0, i32 1
+      %b = load i8, ptr %p
+      %f = uitofp i8 %b to float
+      ret float %f
+    }
+
+    define float @tanh_lut(float %x) {
+      %p = getelementptr [256 x i8], ptr @tanh_lut_ab, i32 0, i32 1
+      %b = load i8, ptr %p
+      %f = uitofp i8 %b to float
+      ret float %f
+    }
+    """
+)
+
+linked, report = aie_llvm_link_pruned([core, kernels])
+
+# The kernel the core calls and the table it reads are kept.
+# CHECK: @exp_ilut_ab = global [512 x i8]
+# CHECK-NOT: @tanh_lut_ab
+# CHECK: define void @core_0_2
+# CHECK: define float @exp_lut
+# CHECK-NOT: define float @tanh_lut
+print(linked)
+
+# CHECK: removed function tanh_lut
+# CHECK: removed global tanh_lut_ab (256 bytes)
+# CHECK: removed 1 functions and 1 globals, freeing 256 bytes of data memory
+print(report)
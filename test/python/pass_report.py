@@ -0,0 +1,64 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# RUN: %PYTHON %s 2>&1 | FileCheck %s
+
+import sys
+from textwrap import dedent
+
+from aie.dialects.aie import run_pass_pipeline, run_pass_pipeline_with_report
+from aie.ir import Context, Location, Module
+
+with Context(), Location.unknown():
+    module = Module.parse(dedent("""\
+            func.func @f(%a: i32) -> i32 {
+              %c0 = arith.constant 0 : i32
+              %0 = arith.addi %a, %c0 : i32
+              return %0 : i32
+            }
+            """))
+    report = run_pass_pipeline_with_report(
+        module.operation, "builtin.module(func.func(canonicalize,cse))"
+    )
+
+# Only the passes themselves are timed, not the adaptor that runs the nested
+# func.func pipeline.
+passes = [
+    line.split("\t")[1] for line in report.splitlines() if line.startswith("pass\t")
+]
+print(passes)
+# CHECK: ['canonicalize', 'cse']
+
+# The addition of zero is folded away.
+# CHECK: op{{\s+}}arith.addi{{\s+}}1{{\s+}}0
+print(report)
+
+# Without a report, the pipeline runs on a plain pass manager.
+with Context(), Location.unknown():
+    module = Module.parse(dedent("""\
+            func.func @g(%a: i32) -> i32 {
+              %c0 = arith.constant 0 : i32
+              %0 = arith.addi %a, %c0 : i32
+              return %0 : i32
+            }
+            """))
+    run_pass_pipeline(module.operation, "builtin.module(canonicalize)")
+    print(module)
+# CHECK-LABEL: func.func @g
+# CHECK-NOT: arith.addi
+# CHECK: return
+
+# A pipeline that does not parse says why.
+sys.stdout.flush()
+for run in (run_pass_pipeline, run_pass_pipeline_with_report):
+    try:
+        run(module.operation, "builtin.module(no-such-pass)")
+    except RuntimeError as e:
+        print(e, flush=True)
+# CHECK: 'no-such-pass' does not refer to a registered pass or pass pipeline
+# CHECK: failed to run pass pipeline: builtin.module(no-such-pass)
+# CHECK: 'no-such-pass' does not refer to a registered pass or pass pipeline
+# CHECK: failed to run pass pipeline: builtin.module(no-such-pass)
@@ -0,0 +1,44 @@
+//===- coalesce_writes.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate -aie-npu-instgen -aie-output-binary=true %s -o ./coalesce_writes_cfg.bin
+// RUN: %python txn2mlir.py -f ./coalesce_writes_cfg.bin | FileCheck %s
+
+// Writes to consecutive buffer descriptor words become one blockwrite, and
+// blockwrites with identical payloads share a single global. Writes to the
+// consecutive control and task queue registers of a DMA channel are kept as
+// separate write32 ops.
+
+// CHECK: aie.device(npu1_1col)
+// CHECK: memref.global "private" constant @blockwrite_data : memref<3xi32> = dense<[1, 2, 3]>
+// CHECK-NOT: memref.global
+// CHECK: %[[D0:.*]] = memref.get_global @blockwrite_data : memref<3xi32>
+// CHECK: aiex.npu.blockwrite(%[[D0]]) {address = 2215968 : ui32} : memref<3xi32>
+// CHECK: aiex.npu.write32 {address = 2215984 : ui32, value = 4 : ui32}
+// CHECK: %[[D1:.*]] = memref.get_global @blockwrite_data : memref<3xi32>
+// CHECK: aiex.npu.blockwrite(%[[D1]]) {address = 2215936 : ui32} : memref<3xi32>
+// CHECK: aiex.npu.write32 {address = 2219520 : ui32, value = 0 : ui32}
+// CHECK: aiex.npu.write32 {address = 2219524 : ui32, value = 2147483648 : ui32}
+// CHECK-NOT: aiex.npu.blockwrite
+module {
+  aie.device(npu1_1col) {
+    memref.global "private" constant @data : memref<3xi32> = dense<[1, 2, 3]>
+    aiex.runtime_sequence() {
+      aiex.npu.write32 {address = 2215968 : ui32, value = 1 : ui32}
+      aiex.npu.write32 {address = 2215972 : ui32, value = 2 : ui32}
+      aiex.npu.write32 {address = 2215976 : ui32, value = 3 : ui32}
+      aiex.npu.write32 {address = 2215984 : ui32, value = 4 : ui32}
+      %0 = memref.get_global @data : memref<3xi32>
+      aiex.npu.blockwrite(%0) {address = 2215936 : ui32} : memref<3xi32>
+      aiex.npu.write32 {address = 2219520 : ui32, value = 0 : ui32}
+      aiex.npu.write32 {address = 2219524 : ui32, value = 2147483648 : ui32}
+    }
+  }
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+
+// REQUIRES: valid_xchess_license
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=32" --convert-vector-to-aievec="aie-target=aie2" -lower-affine | aie-translate -aie2=true --aievec-to-cpp -o dut.cc
+// RUN: xchesscc_wrapper aie2 -f -g +s +w work +o work -I%S -I%aie_runtime_lib%/AIE2 -I %aietools/include -D__AIE_ARCH__=20 -D__AIENGINE__ -I. -c dut.cc -o dut.o
+// RUN: xchesscc_wrapper aie2 -f -g +s +w work +o work -I%S -I%aie_runtime_lib%/AIE2 -I %aietools/include -D__AIE_ARCH__=20 -D__AIENGINE__ -I. %S/testbench.cc work/dut.o
+// RUN: mkdir -p data
+// RUN: xca_udm_dbg --aiearch aie-ml -qf -T -P %aietools/data/aie_ml/lib/ -t "%S/../../profiling.tcl ./work/a.out" >& xca_udm_dbg.stdout
+// RUN: FileCheck --input-file=./xca_udm_dbg.stdout %s
+// CHECK: TEST PASSED
+
+// The constants live in the loop body so that they are vectorized into the
+// splats that the GELU fusion pattern matches.
+module {
+  func.func @dut(%arg0: memref<1024xbf16>, %arg1: memref<1024xbf16>) {
+    affine.for %arg3 = 0 to 1024 {
+      %cst_rsqrt2 = arith.constant 7.070310e-01 : bf16
+      %cst_1 = arith.constant 1.000000e+00 : bf16
+      %cst_0_5 = arith.constant 5.000000e-01 : bf16
+      %0 = affine.load %arg0[%arg3] : memref<1024xbf16>
+      %1 = arith.mulf %0, %cst_rsqrt2 : bf16
+      %2 = math.erf %1 : bf16
+      %3 = arith.addf %2, %cst_1 : bf16
+      %4 = arith.mulf %0, %3 : bf16
+      %5 = arith.mulf %4, %cst_0_5 : bf16
+      affine.store %5, %arg1[%arg3] : memref<1024xbf16>
+    }
+    return
+  }
+}
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+
+// REQUIRES: valid_xchess_license
+// RUN: aie-opt %s -affine-super-vectorize="virtual-vector-size=16" --convert-vector-to-aievec="aie-target=aie2" -lower-affine | aie-translate -aie2=true --aievec-to-cpp -o dut.cc
+// RUN: xchesscc_wrapper aie2 -f -g +s +w work +o work -I%S -I%aie_runtime_lib%/AIE2 -I %aietools/include -D__AIE_ARCH__=20 -D__AIENGINE__ -I. -c %aie_runtime_lib%/AIE2/lut_based_ops.cpp -o lut_based_ops.o
+// RUN: xchesscc_wrapper aie2 -f -g +s +w work +o work -I%S -I%aie_runtime_lib%/AIE2 -I %aietools/include -D__AIE_ARCH__=20 -D__AIENGINE__ -I. -c dut.cc -o dut.o
+// RUN: xchesscc_wrapper aie2 -f -g +s +w work +o work -I%S -I%aie_runtime_lib%/AIE2 -I %aietools/include -D__AIE_ARCH__=20 -D__AIENGINE__ -I. %S/testbench.cc work/dut.o work/lut_based_ops.o
+// RUN: mkdir -p data
+// RUN: xca_udm_dbg --aiearch aie-ml -qf -T -P %aietools/data/aie_ml/lib/ -t "%S/../../profiling.tcl ./work/a.out" >& xca_udm_dbg.stdout
+// RUN: FileCheck --input-file=./xca_udm_dbg.stdout %s
+// CHECK: TEST PASSED
+
+// The constants live in the loop body so that they are vectorized into the
+// splats that the GELU fusion pattern matches.
+module {
+  func.func @dut(%arg0: memref<1024xbf16>, %arg1: memref<1024xbf16>) {
+    affine.for %arg3 = 0 to 1024 {
+      %cst_c = arith.constant 4.467770e-02 : bf16
+      %cst_sqrt_2_over_pi = arith.constant 7.968750e-01 : bf16
+      %cst_1 = arith.constant 1.000000e+00 : bf16
+      %cst_0_5 = arith.constant 5.000000e-01 : bf16
+      %0 = affine.load %arg0[%arg3] : memref<1024xbf16>
+      %1 = arith.mulf %0, %0 : bf16
+      %2 = arith.mulf %1, %0 : bf16
+      %3 = arith.mulf %cst_c, %2 : bf16
+      %4 = arith.addf %0, %3 : bf16
+      %5 = arith.mulf %cst_sqrt_2_over_pi, %4 : bf16
+      %6 = math.tanh %5 : bf16
+      %7 = arith.addf %6, %cst_1 : bf16
+      %8 = arith.mulf %cst_0_5, %0 : bf16
+      %9 = arith.mulf %8, %7 : bf16
+      affine.store %9, %arg1[%arg3] : memref<1024xbf16>
+    }
+    return
+  }
+}
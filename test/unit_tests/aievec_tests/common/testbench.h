@@ -151,6 +151,11 @@ void readData(T *data, unsigned numWords, std::string const &filename) {
 }
 
 bool almostEqual(float val1, float val2, float relTol, float absTol) {
+  // NaN only matches NaN, and infinities only match themselves.
+  if (std::isnan(val1) || std::isnan(val2))
+    return std::isnan(val1) && std::isnan(val2);
+  if (std::isinf(val1) || std::isinf(val2))
+    return val1 == val2;
   return std::fabs(val1 - val2) <=
          std::max(relTol * std::max(std::fabs(val1), std::fabs(val2)), absTol);
 }